@@ -0,0 +1,16 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main(int argc, char* argv[]){
+	// No window and no GL context: atlas pages are only decoded for their size.
+	ofSetupOpenGL(make_shared<ofAppNoWindow>(), 1024, 768, OF_WINDOW);
+
+	// usage: example-benchmark [data path] [output file]
+	ofApp* app = new ofApp();
+	if (argc > 1) app->dataPath = argv[1];
+	if (argc > 2) app->outputPath = argv[2];
+	ofRunApp(app);
+
+}
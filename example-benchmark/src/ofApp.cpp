@@ -0,0 +1,694 @@
+#include "ofApp.h"
+
+#include <spine/extension.h>
+#include <atomic>
+#include <thread>
+
+//--------------------------------------------------------------
+ofApp::ofApp()
+	: dataPath("../../example/data/") {
+}
+
+//--------------------------------------------------------------
+double ofApp::measure(int iterations, function<void()> body){
+	uint64_t start = ofGetElapsedTimeMicros();
+	for (int i = 0; i < iterations; ++i) body();
+	return (ofGetElapsedTimeMicros() - start) / 1000.0 / iterations;
+}
+
+//--------------------------------------------------------------
+void ofApp::report(const string& name, double value, const string& unit, int iterations){
+	stringstream line;
+	line << "{\"name\":\"" << name << "\",\"value\":" << value << ",\"unit\":\"" << unit << "\",\"iterations\":" << iterations << "}";
+	cout << line.str() << endl;
+	if (output.is_open()) output << line.str() << endl;
+}
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	ofSetDataPathRoot(dataPath);
+	ofxSpineSetLoadTextures(false);
+	if (!outputPath.empty()) output.open(outputPath.c_str());
+
+	Asset spineboy = { "spineboy", "spineboy.json", "spineboy.atlas", "", "walk" };
+	Asset goblins = { "goblins-mesh", "goblins-mesh.json", "goblins-mesh.atlas", "goblin", "walk" };
+	assets.push_back(spineboy);
+	assets.push_back(goblins);
+
+	int producers = max(2, (int)std::thread::hardware_concurrency());
+	benchmarkCommandQueue(producers);
+
+	for (size_t i = 0; i < assets.size(); ++i) {
+		const Asset& asset = assets[i];
+		benchmarkLoad(asset);
+		benchmarkFileSource(asset);
+		benchmarkLazyLoad(asset);
+		benchmarkParallelLoad(asset);
+		benchmarkCompression(asset);
+		benchmarkPageTextures(asset);
+
+		spAtlas* atlas = spAtlas_createFromFile(asset.atlas.c_str(), 0);
+		spSkeletonJson* json = spSkeletonJson_create(atlas);
+		spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+		spSkeletonJson_dispose(json);
+		if (!skeletonData) {
+			ofLogError("benchmark") << "could not load " << asset.json;
+			spAtlas_dispose(atlas);
+			continue;
+		}
+
+		benchmarkUpdate(asset, skeletonData, 1);
+		benchmarkUpdate(asset, skeletonData, 100);
+		benchmarkUpdate(asset, skeletonData, 10000);
+		benchmarkPoseCache(asset, skeletonData, 1000);
+		benchmarkWorld(asset, skeletonData);
+		benchmarkGeometry(asset, skeletonData);
+		benchmarkListeners(asset, skeletonData);
+		benchmarkBounds(asset, skeletonData);
+		benchmarkSpatialIndex(asset, skeletonData, 1000);
+		benchmarkSpatialIndex(asset, skeletonData, 10000);
+		benchmarkCommands(asset, skeletonData, producers);
+
+		spSkeletonData_dispose(skeletonData);
+		spAtlas_dispose(atlas);
+	}
+
+	output.close();
+	ofExit();
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkLoad(const Asset& asset){
+	const int iterations = 20;
+
+	double atlasTime = measure(iterations, [&]() {
+		spAtlas_dispose(spAtlas_createFromFile(asset.atlas.c_str(), 0));
+	});
+	report("load.atlas." + asset.name, atlasTime, "ms", iterations);
+
+	spAtlas* atlas = spAtlas_createFromFile(asset.atlas.c_str(), 0);
+	double jsonTime = measure(iterations, [&]() {
+		spSkeletonJson* json = spSkeletonJson_create(atlas);
+		spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+		spSkeletonJson_dispose(json);
+		if (skeletonData) spSkeletonData_dispose(skeletonData);
+	});
+	report("load.json." + asset.name, jsonTime, "ms", iterations);
+	spAtlas_dispose(atlas);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkFileSource(const Asset& asset){
+	const int iterations = 100;
+	shared_ptr<ofxSpineFileSource> previous = ofxSpineGetFileSource();
+	auto source = ofxSpineMappedFileSource::create();
+	ofxSpineSetFileSource(source);
+
+	string files[] = { asset.json, asset.atlas };
+	for (int f = 0; f < 2; ++f) {
+		const string& path = files[f];
+		string name = "file_source." + asset.name + (f == 0 ? ".json" : ".atlas");
+
+		// What _spUtil_readFile did before: read the whole file into a new buffer every time.
+		double readTime = measure(iterations, [&]() {
+			int length = 0;
+			char* data = _readFile(ofToDataPath(path).c_str(), &length);
+			FREE(data);
+		});
+		source->clear();
+		source->resetStats();
+		double copyTime = measure(iterations, [&]() {
+			int length = 0;
+			FREE(source->readCopy(path, &length));
+		});
+		ofxSpineFileSource::Stats stats = source->getStats();
+		// Mappings are only shared while held, like ofxSkeletonLazyData holds its file.
+		shared_ptr<ofxSpineFile> held = ofxSpineOpenFile(path);
+		double openTime = measure(iterations, [&]() {
+			ofxSpineOpenFile(path);
+		});
+		held.reset();
+
+		report(name + ".read", readTime, "ms", iterations);
+		report(name + ".mapped_copy", copyTime, "ms", iterations);
+		report(name + ".mapped_in_place", openTime, "ms", iterations);
+		report(name + ".saved", readTime - copyTime, "ms", iterations);
+		report(name + ".bytes.mapped", stats.mappedBytes, "bytes", iterations);
+		report(name + ".bytes.read", stats.readBytes, "bytes", iterations);
+		report(name + ".bytes.copied", stats.copiedBytes, "bytes", iterations);
+		report(name + ".shared", stats.shared, "count", iterations);
+	}
+
+	ofxSpineSetFileSource(previous);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkLazyLoad(const Asset& asset){
+	const int iterations = 20;
+	spAtlas* atlas = spAtlas_createFromFile(asset.atlas.c_str(), 0);
+	string name = "lazy_load." + asset.name;
+
+	double indexTime = measure(iterations, [&]() {
+		ofxSkeletonLazyData data(asset.json.c_str(), atlas);
+	});
+	report(name + ".index", indexTime, "ms", iterations);
+
+	double firstUseTime = measure(iterations, [&]() {
+		ofxSkeletonLazyData data(asset.json.c_str(), atlas);
+		data.load(asset.animation.c_str());
+	});
+	report(name + ".first_use", firstUseTime, "ms", iterations);
+
+	// Resident timeline memory with one clip versus every clip, checked against the eager load.
+	spSkeletonJson* json = spSkeletonJson_create(atlas);
+	spSkeletonData* eager = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+	spSkeletonJson_dispose(json);
+	auto lazy = ofxSkeletonLazyData::createWithFile(asset.json.c_str(), atlas);
+	spSkeletonData* lazyData = lazy->getSkeletonData();
+	if (!eager || !lazyData) {
+		ofLogError("benchmark") << name << ": could not load";
+	} else {
+		size_t eagerBytes = 0;
+		for (int i = 0; i < eager->animationsCount; ++i) eagerBytes += ofxSkeletonLazyData::getAnimationBytes(eager->animations[i]);
+		lazy->load(asset.animation.c_str());
+		report(name + ".resident.one", lazy->getResidentBytes() + lazy->getSourceBytes(), "bytes", 1);
+		for (int i = 0; i < lazyData->animationsCount; ++i) lazy->load(lazyData->animations[i]);
+		report(name + ".resident.all", lazy->getResidentBytes(), "bytes", 1);
+		report(name + ".resident.eager", eagerBytes, "bytes", 1);
+		report(name + ".load_all", lazy->getLoadMillis(), "ms", lazy->getLoads());
+
+		bool same = eager->animationsCount == lazyData->animationsCount;
+		for (int i = 0; same && i < eager->animationsCount; ++i) {
+			spAnimation* a = eager->animations[i];
+			spAnimation* b = lazyData->animations[i];
+			same = strcmp(a->name, b->name) == 0 && a->duration == b->duration && a->timelinesCount == b->timelinesCount
+				&& ofxSkeletonLazyData::getAnimationBytes(a) == ofxSkeletonLazyData::getAnimationBytes(b);
+		}
+		if (!same) ofLogError("benchmark") << name << ": lazily loaded animations differ from the eager load";
+
+		lazy->beginFrame();
+		lazy->beginFrame();
+		lazy->evictUnused(1);
+		report(name + ".resident.evicted", lazy->getResidentBytes(), "bytes", 1);
+	}
+	if (eager) spSkeletonData_dispose(eager);
+	lazy.reset();
+	spAtlas_dispose(atlas);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkParallelLoad(const Asset& asset){
+	const int iterations = 20;
+	spAtlas* atlas = spAtlas_createFromFile(asset.atlas.c_str(), 0);
+	string name = "parallel_load." + asset.name;
+
+	spSkeletonJson* json = spSkeletonJson_create(atlas);
+	spSkeletonData* serial = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+	spSkeletonJson_dispose(json);
+	if (!serial) {
+		ofLogError("benchmark") << name << ": could not load";
+		spAtlas_dispose(atlas);
+		return;
+	}
+
+	int hardware = max(1, (int)std::thread::hardware_concurrency());
+	vector<int> threadCounts;
+	for (int threads = 1; threads < hardware; threads *= 2) threadCounts.push_back(threads);
+	threadCounts.push_back(hardware);
+	for (size_t t = 0; t < threadCounts.size(); ++t) {
+		int threads = threadCounts[t];
+		ofxSkeletonParallelJson::Stats stats;
+		double loadTime = measure(iterations, [&]() {
+			spSkeletonData* skeletonData = ofxSkeletonParallelJson::readSkeletonDataFile(asset.json.c_str(), atlas, 1, threads, &stats);
+			if (skeletonData) spSkeletonData_dispose(skeletonData);
+		});
+		report(name + "." + ofToString(threads), loadTime, "ms", iterations);
+		if (t == 0) report(name + ".tasks", stats.tasks, "count", 1);
+	}
+
+	// Same skins, animations and timelines as the serial reader, in the same order.
+	spSkeletonData* parallel = ofxSkeletonParallelJson::readSkeletonDataFile(asset.json.c_str(), atlas, 1, hardware);
+	bool same = parallel && parallel->skinsCount == serial->skinsCount && parallel->animationsCount == serial->animationsCount
+		&& parallel->eventsCount == serial->eventsCount;
+	for (int i = 0; same && i < serial->skinsCount; ++i) {
+		same = strcmp(serial->skins[i]->name, parallel->skins[i]->name) == 0
+			&& (serial->defaultSkin == serial->skins[i]) == (parallel->defaultSkin == parallel->skins[i]);
+	}
+	for (int i = 0; same && i < serial->animationsCount; ++i) {
+		spAnimation* a = serial->animations[i];
+		spAnimation* b = parallel->animations[i];
+		same = strcmp(a->name, b->name) == 0 && a->duration == b->duration && a->timelinesCount == b->timelinesCount
+			&& ofxSkeletonLazyData::getAnimationBytes(a) == ofxSkeletonLazyData::getAnimationBytes(b);
+	}
+	if (!same) ofLogError("benchmark") << name << ": parallel load differs from the serial load";
+	report(name + ".serial", measure(iterations, [&]() {
+		spSkeletonJson* json = spSkeletonJson_create(atlas);
+		spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+		spSkeletonJson_dispose(json);
+		if (skeletonData) spSkeletonData_dispose(skeletonData);
+	}), "ms", iterations);
+
+	if (parallel) spSkeletonData_dispose(parallel);
+	spSkeletonData_dispose(serial);
+	spAtlas_dispose(atlas);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkCompression(const Asset& asset){
+	spAtlas* atlas = spAtlas_createFromFile(asset.atlas.c_str(), 0);
+	spSkeletonJson* json = spSkeletonJson_create(atlas);
+	spSkeletonData* reference = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+	spSkeletonData* compressed = spSkeletonJson_readSkeletonDataFile(json, asset.json.c_str());
+	spSkeletonJson_dispose(json);
+	string name = "compression." + asset.name;
+	if (!reference || !compressed) {
+		ofLogError("benchmark") << name << ": could not load";
+	} else {
+		ofxSkeletonCompression::Report result;
+		double compressTime = measure(1, [&]() {
+			result = ofxSkeletonCompression::compress(compressed);
+		});
+		report(name + ".time", compressTime, "ms", 1);
+		report(name + ".timelines", result.timelines, "count", 1);
+		report(name + ".keys.before", result.keysBefore, "count", 1);
+		report(name + ".keys.after", result.keysAfter, "count", 1);
+		report(name + ".bytes.before", result.bytesBefore, "bytes", 1);
+		report(name + ".bytes.after", result.bytesAfter, "bytes", 1);
+
+		// Pose both at 60 Hz over every animation and compare world positions and slot colors.
+		spSkeleton* expected = spSkeleton_create(reference);
+		spSkeleton* actual = spSkeleton_create(compressed);
+		if (!asset.skin.empty()) {
+			spSkeleton_setSkinByName(expected, asset.skin.c_str());
+			spSkeleton_setSkinByName(actual, asset.skin.c_str());
+		}
+		float maxPositionError = 0, maxColorError = 0;
+		int samples = 0;
+		double referenceTime = 0, compressedTime = 0;
+		for (int i = 0; i < reference->animationsCount; ++i) {
+			spAnimation* expectedAnimation = reference->animations[i];
+			spAnimation* actualAnimation = compressed->animations[i];
+			for (float time = 0; time <= expectedAnimation->duration; time += 1 / 60.0f) {
+				uint64_t start = ofGetElapsedTimeMicros();
+				spSkeleton_setToSetupPose(expected);
+				spAnimation_apply(expectedAnimation, expected, time, time, 0, 0, 0);
+				spSkeleton_updateWorldTransform(expected);
+				uint64_t middle = ofGetElapsedTimeMicros();
+				spSkeleton_setToSetupPose(actual);
+				spAnimation_apply(actualAnimation, actual, time, time, 0, 0, 0);
+				spSkeleton_updateWorldTransform(actual);
+				referenceTime += (middle - start) / 1000.0;
+				compressedTime += (ofGetElapsedTimeMicros() - middle) / 1000.0;
+				samples++;
+
+				for (int ii = 0; ii < expected->bonesCount; ++ii) {
+					spBone* a = expected->bones[ii];
+					spBone* b = actual->bones[ii];
+					maxPositionError = max(maxPositionError, max(fabsf(a->worldX - b->worldX), fabsf(a->worldY - b->worldY)));
+				}
+				for (int ii = 0; ii < expected->slotsCount; ++ii) {
+					spSlot* a = expected->slots[ii];
+					spSlot* b = actual->slots[ii];
+					maxColorError = max(maxColorError, max(max(fabsf(a->r - b->r), fabsf(a->g - b->g)), max(fabsf(a->b - b->b), fabsf(a->a - b->a))));
+				}
+			}
+		}
+		report(name + ".max_position_error", maxPositionError, "units", samples);
+		report(name + ".max_color_error", maxColorError, "ratio", samples);
+		report(name + ".pose.reference", referenceTime * 1000 / max(samples, 1), "us", samples);
+		report(name + ".pose.compressed", compressedTime * 1000 / max(samples, 1), "us", samples);
+		spSkeleton_dispose(expected);
+		spSkeleton_dispose(actual);
+	}
+	if (reference) spSkeletonData_dispose(reference);
+	if (compressed) spSkeletonData_dispose(compressed);
+	spAtlas_dispose(atlas);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkPageTextures(const Asset& asset){
+	// Reading and decoding only: without a GL context nothing is uploaded, so VRAM is what the upload would allocate. The
+	// compressed pass does not ask the GL for format support (decode false), which would need a context.
+	spAtlas* atlas = spAtlas_createFromFile(asset.atlas.c_str(), 0);
+	if (!atlas) return;
+	string directory = ofFilePath::getEnclosingDirectory(asset.atlas, false);
+	bool enabled = ofxSpineTextureLoader::getCompressedEnabled();
+	const int iterations = 5;
+	for (int compressed = 0; compressed < 2; ++compressed) {
+		ofxSpineTextureLoader::setCompressedEnabled(compressed != 0);
+		size_t bytes = 0;
+		int found = 0;
+		double loadTime = measure(iterations, [&]() {
+			bytes = 0;
+			found = 0;
+			for (spAtlasPage* page = atlas->pages; page; page = page->next) {
+				ofxSpineTextureLoader::Image image;
+				if (!ofxSpineTextureLoader::load(directory + page->name, image, compressed == 0)) continue;
+				bytes += image.getBytes();
+				if (image.compressed == (compressed != 0)) found++;
+			}
+		});
+		string name = "page_textures." + asset.name + (compressed ? ".compressed" : ".png");
+		report(name + ".pages", found, "count", iterations);
+		report(name + ".load", loadTime, "ms", iterations);
+		report(name + ".vram", bytes, "bytes", iterations);
+	}
+	ofxSpineTextureLoader::setCompressedEnabled(enabled);
+	spAtlas_dispose(atlas);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkUpdate(const Asset& asset, spSkeletonData* skeletonData, int instances){
+	vector<shared_ptr<ofxSkeletonAnimation> > skeletons;
+	for (int i = 0; i < instances; ++i) {
+		auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+		if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+		skeleton->setAnimation(0, asset.animation.c_str(), true);
+		// Spread the instances over the clip so they do not all hit the same keys.
+		skeleton->update(i * 0.01f);
+		skeletons.push_back(skeleton);
+	}
+
+	const int frames = instances >= 10000 ? 10 : 200;
+	double frameTime = measure(frames, [&]() {
+		for (auto& skeleton : skeletons) skeleton->update(1 / 60.0f);
+	});
+	report("update." + asset.name + "." + ofToString(instances), frameTime, "ms/frame", frames);
+	report("update." + asset.name + "." + ofToString(instances) + ".per_instance", frameTime * 1000 / instances, "us", frames);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkPoseCache(const Asset& asset, spSkeletonData* skeletonData, int instances){
+	// A crowd in 8 groups, each group playing the clip in sync.
+	auto cache = ofxSkeletonPoseCache::create();
+	vector<shared_ptr<ofxSkeletonAnimation> > skeletons;
+	for (int i = 0; i < instances; ++i) {
+		auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+		if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+		skeleton->setAnimation(0, asset.animation.c_str(), true);
+		skeleton->update((i % 8) * 0.1f);
+		skeleton->setPoseCache(cache);
+		skeletons.push_back(skeleton);
+	}
+
+	const int frames = 100;
+	double savedMillis = 0, hitRate = 0;
+	double frameTime = measure(frames, [&]() {
+		cache->beginFrame();
+		for (auto& skeleton : skeletons) skeleton->update(1 / 60.0f);
+		savedMillis += cache->getSavedMillis();
+		hitRate += cache->getHitRate();
+	});
+	string name = "pose_cache." + asset.name + "." + ofToString(instances);
+	report(name, frameTime, "ms/frame", frames);
+	report(name + ".hit_rate", hitRate / frames, "ratio", frames);
+	report(name + ".saved", savedMillis / frames, "ms/frame", frames);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkWorld(const Asset& asset, spSkeletonData* skeletonData){
+	string name = "world." + asset.name;
+
+	// The same 5.5 steps as eleven frames of half a step and as two frames that run 2 and 3 steps: both draw halfway
+	// between steps 5 and 6. Steps of 1/64 s keep the accumulators exact.
+	const float stepsPerSecond = 64;
+	const float frameSteps[] = { 0.5f, 2.75f };
+	const int frames[] = { 11, 2 };
+	ofxSkeletonPose poses[2];
+	bool found = true;
+	for (int run = 0; run < 2; ++run) {
+		auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+		if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+		skeleton->setAnimation(0, asset.animation.c_str(), true);
+		auto world = ofxSkeletonWorld::create(stepsPerSecond);
+		world->add(skeleton);
+		for (int i = 0; i < frames[run]; ++i) world->update(frameSteps[run] / stepsPerSecond);
+		found = world->getInterpolatedPose(skeleton, poses[run]) && found;
+	}
+
+	float maxError = 0;
+	for (size_t i = 0; found && i < poses[0].bones.size(); ++i) {
+		maxError = max(maxError, fabsf(poses[0].bones[i].worldX - poses[1].bones[i].worldX));
+		maxError = max(maxError, fabsf(poses[0].bones[i].worldY - poses[1].bones[i].worldY));
+	}
+	if (!found || maxError > 0.001f) ofLogError("benchmark") << name << ": catch-up pose differs from stepping every frame";
+	report(name + ".catch_up_error", maxError, "units", 2);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkGeometry(const Asset& asset, spSkeletonData* skeletonData){
+	auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+	if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+	skeleton->setAnimation(0, asset.animation.c_str(), true);
+	skeleton->update(0.1f);
+
+	vector<float> worldVertices(1000);
+	ofTexture texture; // Never bound, the batch is cleared before it draws.
+	auto batch = ofxPolygonBatch::createWithCapacity(10920);
+	static const int quadTriangles[6] = {0, 1, 2, 2, 3, 0};
+
+	const spAttachmentType types[] = { SP_ATTACHMENT_REGION, SP_ATTACHMENT_MESH, SP_ATTACHMENT_WEIGHTED_MESH };
+	const char* typeNames[] = { "region", "mesh", "weighted_mesh" };
+	const int iterations = 2000;
+
+	for (int t = 0; t < 3; ++t) {
+		spSkeleton* sk = skeleton->skeleton;
+		int verticesPerPass = 0;
+		for (int i = 0; i < sk->slotsCount; ++i) {
+			spSlot* slot = sk->drawOrder[i];
+			if (!slot->attachment || slot->attachment->type != types[t]) continue;
+			switch (types[t]) {
+			case SP_ATTACHMENT_REGION: verticesPerPass += 4; break;
+			case SP_ATTACHMENT_MESH: verticesPerPass += ((spMeshAttachment*)slot->attachment)->verticesCount / 2; break;
+			case SP_ATTACHMENT_WEIGHTED_MESH: verticesPerPass += ((spWeightedMeshAttachment*)slot->attachment)->uvsCount / 2; break;
+			default: break;
+			}
+		}
+		if (!verticesPerPass) continue;
+
+		double worldTime = measure(iterations, [&]() {
+			for (int i = 0; i < sk->slotsCount; ++i) {
+				spSlot* slot = sk->drawOrder[i];
+				if (!slot->attachment || slot->attachment->type != types[t]) continue;
+				switch (types[t]) {
+				case SP_ATTACHMENT_REGION:
+					spRegionAttachment_computeWorldVertices((spRegionAttachment*)slot->attachment, slot->bone, worldVertices.data());
+					break;
+				case SP_ATTACHMENT_MESH:
+					spMeshAttachment_computeWorldVertices((spMeshAttachment*)slot->attachment, slot, worldVertices.data());
+					break;
+				case SP_ATTACHMENT_WEIGHTED_MESH:
+					spWeightedMeshAttachment_computeWorldVertices((spWeightedMeshAttachment*)slot->attachment, slot, worldVertices.data());
+					break;
+				default: break;
+				}
+			}
+		});
+		report("geometry.world_vertices." + string(typeNames[t]) + "." + asset.name, verticesPerPass / worldTime / 1000, "Mvertices/s", iterations);
+
+		double batchTime = measure(iterations, [&]() {
+			for (int i = 0; i < sk->slotsCount; ++i) {
+				spSlot* slot = sk->drawOrder[i];
+				if (!slot->attachment || slot->attachment->type != types[t]) continue;
+				switch (types[t]) {
+				case SP_ATTACHMENT_REGION: {
+					spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
+					batch->add(&texture, worldVertices.data(), attachment->uvs, 8, quadTriangles, 6, ofColor::white);
+					break;
+				}
+				case SP_ATTACHMENT_MESH: {
+					spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
+					batch->add(&texture, worldVertices.data(), attachment->uvs, attachment->verticesCount, attachment->triangles, attachment->trianglesCount, ofColor::white);
+					break;
+				}
+				case SP_ATTACHMENT_WEIGHTED_MESH: {
+					spWeightedMeshAttachment* attachment = (spWeightedMeshAttachment*)slot->attachment;
+					batch->add(&texture, worldVertices.data(), attachment->uvs, attachment->uvsCount, attachment->triangles, attachment->trianglesCount, ofColor::white);
+					break;
+				}
+				default: break;
+				}
+			}
+			batch->clear();
+		});
+		report("geometry.batch_fill." + string(typeNames[t]) + "." + asset.name, verticesPerPass / batchTime / 1000, "Mvertices/s", iterations);
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkListeners(const Asset& asset, spSkeletonData* skeletonData){
+	auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+	int calls = 0;
+	skeleton->completeListener = [&calls](int, int loopCount) {
+		calls += loopCount;
+	};
+
+	const int iterations = 1000000;
+	double dispatchTime = measure(iterations, [&]() {
+		skeleton->onAnimationStateEvent(0, SP_ANIMATION_COMPLETE, 0, 1);
+	});
+	report("listeners.dispatch." + asset.name, dispatchTime * 1000000, "ns", iterations);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkBounds(const Asset& asset, spSkeletonData* skeletonData){
+	auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+	if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+	skeleton->setAnimation(0, asset.animation.c_str(), true);
+	skeleton->update(0.1f);
+
+	const int iterations = 10000;
+	float sink = 0;
+	double boundsTime = measure(iterations, [&]() {
+		sink += skeleton->boundingBox().width;
+	});
+	report("bounds." + asset.name, boundsTime * 1000, "us", iterations);
+	if (sink < 0) cout << sink << endl;
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkSpatialIndex(const Asset& asset, spSkeletonData* skeletonData, int instances){
+	// Constant density: the world grows with the crowd, so a sub-linear query stays flat.
+	float worldSize = sqrtf((float)instances) * 300;
+	ofSeedRandom(1);
+	vector<shared_ptr<ofxSkeletonAnimation> > skeletons;
+	for (int i = 0; i < instances; ++i) {
+		auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+		if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+		skeleton->setAnimation(0, asset.animation.c_str(), true);
+		skeleton->update(i * 0.01f);
+		skeleton->setPosition(ofVec2f(ofRandom(worldSize), ofRandom(worldSize)));
+		skeleton->boundingBox(); // Fills the cached bounds, as draw() would.
+		skeletons.push_back(skeleton);
+	}
+	string name = "spatial_index." + asset.name + "." + ofToString(instances);
+
+	auto index = ofxSkeletonSpatialIndex::create(256);
+	double buildTime = measure(1, [&]() {
+		for (auto& skeleton : skeletons) index->add(skeleton);
+	});
+	report(name + ".build", buildTime, "ms", 1);
+
+	// Everyone walks a little each frame; only instances crossing a cell border move.
+	const int frames = 20;
+	double updateTime = measure(frames, [&]() {
+		for (auto& skeleton : skeletons) skeleton->setPosition(skeleton->getPosition() + ofVec2f(2, 0));
+		index->update();
+	});
+	report(name + ".update", updateTime, "ms/frame", frames);
+
+	const int queries = 1000;
+	vector<ofVec2f> points;
+	for (int i = 0; i < queries; ++i) points.push_back(ofVec2f(ofRandom(worldSize), ofRandom(worldSize)));
+
+	size_t found = 0, candidates = 0;
+	vector<shared_ptr<ofxSkeletonRenderer> > results;
+	int next = 0;
+	double pointTime = measure(queries, [&]() {
+		results.clear();
+		index->queryPoint(points[next].x, points[next].y, results);
+		found += results.size();
+		candidates += index->getCandidatesCount();
+		next++;
+	});
+	report(name + ".query_point", pointTime * 1000, "us", queries);
+	report(name + ".query_point.candidates", candidates / (double)queries, "instances", queries);
+
+	size_t linearFound = 0;
+	next = 0;
+	double linearTime = measure(queries, [&]() {
+		for (auto& skeleton : skeletons)
+			if (skeleton->getCachedBounds().inside(points[next].x, points[next].y)) linearFound++;
+		next++;
+	});
+	report(name + ".query_point.linear", linearTime * 1000, "us", queries);
+	if (found != linearFound) ofLogError("benchmark") << name << ": index found " << found << ", linear scan " << linearFound;
+
+	next = 0;
+	double rectTime = measure(queries, [&]() {
+		results.clear();
+		index->queryRect(ofRectangle(points[next].x, points[next].y, 512, 384), results);
+		next++;
+	});
+	report(name + ".query_rect", rectTime * 1000, "us", queries);
+
+	vector<ofxSkeletonSpatialIndex::Hit> hits;
+	next = 0;
+	double hitTime = measure(queries, [&]() {
+		hits.clear();
+		index->hitTest(points[next].x, points[next].y, hits);
+		next++;
+	});
+	report(name + ".hit_test", hitTime * 1000, "us", queries);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkCommandQueue(int producers){
+	// Stress test: every producer pushes an increasing sequence; the consumer checks each producer's order.
+	const int itemsPerProducer = 200000;
+	ofxSpineQueue<pair<int, int> > queue(1024);
+	vector<int> nextSequence(producers, 0);
+	int orderingErrors = 0;
+	int received = 0;
+
+	uint64_t start = ofGetElapsedTimeMicros();
+	vector<std::thread> threads;
+	for (int p = 0; p < producers; ++p) {
+		threads.push_back(std::thread([&queue, p, itemsPerProducer]() {
+			for (int i = 0; i < itemsPerProducer; ++i) {
+				while (!queue.push(make_pair(p, i))) std::this_thread::yield();
+			}
+		}));
+	}
+	pair<int, int> item;
+	while (received < producers * itemsPerProducer) {
+		if (!queue.pop(item)) continue;
+		if (item.second != nextSequence[item.first]) orderingErrors++;
+		nextSequence[item.first] = item.second + 1;
+		received++;
+	}
+	for (auto& thread : threads) thread.join();
+	double millis = (ofGetElapsedTimeMicros() - start) / 1000.0;
+
+	report("queue.throughput." + ofToString(producers) + "_producers", received / millis / 1000, "Mitems/s", received);
+	report("queue.ordering_errors", orderingErrors, "count", received);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkCommands(const Asset& asset, spSkeletonData* skeletonData, int producers){
+	// Producers drive one skeleton through the command queue while the main thread keeps updating it.
+	auto skeleton = ofxSkeletonAnimation::createWithData(skeletonData);
+	if (!asset.skin.empty()) skeleton->setSkin(asset.skin.c_str());
+	spAnimation* animation = skeleton->findAnimation(asset.animation.c_str());
+	if (!animation) return;
+
+	const int commandsPerProducer = 20000;
+	std::atomic<int> rejected(0);
+	std::atomic<int> finished(0);
+	vector<std::thread> threads;
+	uint64_t start = ofGetElapsedTimeMicros();
+	for (int p = 0; p < producers; ++p) {
+		threads.push_back(std::thread([&, p]() {
+			for (int i = 0; i < commandsPerProducer; ++i) {
+				bool queued = (i & 1) ? skeleton->queueAddAnimation(p & 3, animation, true) : skeleton->queueSetAnimation(p & 3, animation, true);
+				if (!queued) {
+					rejected++;
+					std::this_thread::yield();
+				}
+			}
+			finished++;
+		}));
+	}
+	int frames = 0;
+	while (finished < producers) {
+		skeleton->update(1 / 60.0f);
+		frames++;
+	}
+	skeleton->update(1 / 60.0f);
+	for (auto& thread : threads) thread.join();
+	double millis = (ofGetElapsedTimeMicros() - start) / 1000.0;
+
+	int applied = producers * commandsPerProducer - rejected;
+	report("commands.throughput." + asset.name, applied / millis, "commands/ms", frames);
+	report("commands.rejected." + asset.name, rejected, "count", frames);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxSpineC.h"
+
+/** Headless benchmarks. Every result is one JSON object per line: {"name":..., "value":..., "unit":..., "iterations":...}.
+  * Names are stable between releases so results can be diffed. */
+class ofApp : public ofBaseApp{
+
+	public:
+
+		ofApp();
+
+		void setup();
+
+		string dataPath;
+		string outputPath;
+
+	private:
+
+		struct Asset {
+			string name;
+			string json;
+			string atlas;
+			string skin;
+			string animation;
+		};
+
+		void benchmarkLoad(const Asset& asset);
+		void benchmarkFileSource(const Asset& asset);
+		void benchmarkLazyLoad(const Asset& asset);
+		void benchmarkParallelLoad(const Asset& asset);
+		void benchmarkCompression(const Asset& asset);
+		void benchmarkPageTextures(const Asset& asset);
+		void benchmarkUpdate(const Asset& asset, spSkeletonData* skeletonData, int instances);
+		void benchmarkPoseCache(const Asset& asset, spSkeletonData* skeletonData, int instances);
+		void benchmarkWorld(const Asset& asset, spSkeletonData* skeletonData);
+		void benchmarkGeometry(const Asset& asset, spSkeletonData* skeletonData);
+		void benchmarkListeners(const Asset& asset, spSkeletonData* skeletonData);
+		void benchmarkBounds(const Asset& asset, spSkeletonData* skeletonData);
+		void benchmarkSpatialIndex(const Asset& asset, spSkeletonData* skeletonData, int instances);
+		void benchmarkCommandQueue(int producers);
+		void benchmarkCommands(const Asset& asset, spSkeletonData* skeletonData, int producers);
+
+		/* Returns milliseconds per iteration. */
+		double measure(int iterations, function<void()> body);
+		void report(const string& name, double value, const string& unit, int iterations);
+
+		vector<Asset> assets;
+		ofstream output;
+};
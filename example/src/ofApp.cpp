@@ -42,23 +42,26 @@ void ofApp::setup(){
 	
 	//skel_render->setAnimation(0, "walk", true);
 
+	skel_render->setPosition(ofVec2f(512, 376));
+
 	skel_render->debugBones = true;
 	skel_render->debugSlots = true;
 
+	world = ofxSkeletonWorld::create(60);
+	world->maxStepsPerFrame = 8;
+	world->add(skel_render);
 
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
-	skel_render->update(ofGetLastFrameTime());
+	ofxSpineStats::global().reset();
+	world->update(ofGetLastFrameTime());
 }
 
 //--------------------------------------------------------------
 void ofApp::draw(){
-	ofPushMatrix();
-	ofTranslate(512, 376);
-	skel_render->draw();
-	ofPopMatrix();
+	world->draw();
 }
 
 //--------------------------------------------------------------
@@ -73,6 +76,15 @@ void ofApp::keyPressed(int key){
 	{
 		skel_render->addAnimation(0, "death", false);
 	}
+	if (key == 's')
+	{
+		printf("%s\n", ofxSpineStats::global().toJSON().c_str());
+	}
+	if (key == 't')
+	{
+		if (ofxSpineTrace::isRecording()) ofxSpineTrace::end("spine_trace.json");
+		else ofxSpineTrace::begin();
+	}
 }
 
 //--------------------------------------------------------------
@@ -26,4 +26,5 @@ class ofApp : public ofBaseApp{
 		//void endTracker(int trackIndex) { cout << trackIndex << endl; }
 
 		shared_ptr<ofxSkeletonAnimation> skel_render;
+		shared_ptr<ofxSkeletonWorld> world;
 };
@@ -42,7 +42,9 @@ ofxPolygonBatch::ofxPolygonBatch() :
 	capacity(0), 
 	vertices(nullptr), verticesCount(0),
 	triangles(nullptr), trianglesCount(0),
-	texture(nullptr)
+	texture(nullptr),
+	drawnTexture(nullptr),
+	stats(nullptr)
 {}
 
 bool ofxPolygonBatch::initWithCapacity (int capacity) {
@@ -63,14 +65,13 @@ ofxPolygonBatch::~ofxPolygonBatch() {
 void ofxPolygonBatch::add (ofTexture* addTexture,
 		const float* addVertices, const float* uvs, int addVerticesCount,
 		const int* addTriangles, int addTrianglesCount,
-		ofColor color) 
+		ofColor color, const float* transform) 
 {
 
-	if (
-		addTexture != texture
-		|| verticesCount + (addVerticesCount >> 1) > capacity
-		|| trianglesCount + addTrianglesCount > capacity * 3) {
-		//this->flush();
+	bool overflow = verticesCount + (addVerticesCount >> 1) > capacity || trianglesCount + addTrianglesCount > capacity * 3;
+	if (addTexture != texture || overflow) {
+		if (overflow) OFX_SPINE_COUNT(stats, batchOverflows, 1);
+		this->draw();
 		texture = addTexture;
 	}
 	
@@ -79,8 +80,13 @@ void ofxPolygonBatch::add (ofTexture* addTexture,
 
 	for (int i = 0; i < addVerticesCount; i += 2, ++verticesCount) {
 		PolygonVertex* vertex = vertices + verticesCount;
-		vertex->vertex.x = addVertices[i];
-		vertex->vertex.y = addVertices[i + 1];
+		if (transform) {
+			vertex->vertex.x = transform[0] * addVertices[i] + transform[1] * addVertices[i + 1] + transform[2];
+			vertex->vertex.y = transform[3] * addVertices[i] + transform[4] * addVertices[i + 1] + transform[5];
+		} else {
+			vertex->vertex.x = addVertices[i];
+			vertex->vertex.y = addVertices[i + 1];
+		}
 		vertex->color = color;
 		// add texture type
 		vertex->texCoord.x = uvs[i] * (texture->texData.textureTarget == GL_TEXTURE_2D? 1.0 : texture->texData.width);
@@ -91,6 +97,13 @@ void ofxPolygonBatch::add (ofTexture* addTexture,
 void ofxPolygonBatch::draw () {
 	if (!verticesCount) return;
 
+	OFX_SPINE_TIMER(stats, submitTime);
+	OFX_SPINE_COUNT(stats, drawCalls, 1);
+	if (texture != drawnTexture) OFX_SPINE_COUNT(stats, textureBinds, 1);
+	drawnTexture = texture;
+	OFX_SPINE_COUNT(stats, vertices, verticesCount);
+	OFX_SPINE_COUNT(stats, triangles, trianglesCount / 3);
+
 	texture->bind();
 	/*
 	glEnableVertexAttribArray(kCCVertexAttrib_Position);
@@ -117,3 +130,8 @@ void ofxPolygonBatch::draw () {
 	verticesCount = 0;
 	trianglesCount = 0;
 }
+
+void ofxPolygonBatch::clear () {
+	verticesCount = 0;
+	trianglesCount = 0;
+}
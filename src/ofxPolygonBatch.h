@@ -2,6 +2,7 @@
 #pragma once
 
 #include "ofMain.h"
+#include "ofxSpineStats.h"
 
 class ofxPolygonBatch
 {
@@ -21,11 +22,17 @@ public:
 	virtual ~ofxPolygonBatch();
 
 	bool initWithCapacity (int capacity);
+	/* @param transform Affine matrix applied to the vertices, see ofxSkeletonTransform::getMatrix. May be 0. */
 	void add (ofTexture* texture,
 		const float* vertices, const float* uvs, int verticesCount,
 		const int* triangles, int trianglesCount,
-		ofColor color);
+		ofColor color, const float* transform = 0);
 	void draw ();
+	/* Discards the pending vertices without drawing them. */
+	void clear ();
+
+	/* Counters are added to stats (may be 0) and ofxSpineStats::global(). */
+	void setStats (ofxSpineStats* stats) { this->stats = stats; }
 
 private:
 	int capacity;
@@ -34,4 +41,6 @@ private:
 	GLushort* triangles;
 	int trianglesCount;
 	ofTexture* texture;
+	ofTexture* drawnTexture; // By the last draw().
+	ofxSpineStats* stats;
 };
@@ -79,12 +79,161 @@ ofxSkeletonAnimation::~ofxSkeletonAnimation() {
 }
 
 void ofxSkeletonAnimation::update (float deltaTime) {
+	applyCommands();
 	super::update(deltaTime);
 
+	if (lazyData) {
+		for (int i = 0; i < state->tracksCount; ++i) {
+			spTrackEntry* entry = state->tracks[i];
+			if (!entry) continue;
+			lazyData->touch(entry->animation);
+			if (entry->previous) lazyData->touch(entry->previous->animation);
+			for (spTrackEntry* next = entry->next; next; next = next->next) lazyData->touch(next->animation);
+		}
+	}
+
 	deltaTime *= timeScale;
-	spAnimationState_update(state, deltaTime);
-	spAnimationState_apply(state, skeleton);
-	spSkeleton_updateWorldTransform(skeleton);
+	{
+		OFX_SPINE_TIMER(&stats, applyTime);
+		spAnimationState_update(state, deltaTime);
+	}
+
+	ofxSkeletonPoseCache::Key key;
+	if (poseCache && poseCache->makeKey(state, skeleton, key)) {
+		const ofxSkeletonPose* pose = poseCache->find(key);
+		if (pose) {
+			pose->applyBones(skeleton);
+			applySlots();
+			applyEvents();
+		} else {
+			uint64_t start = ofGetElapsedTimeMicros();
+			applyPose();
+			poseCache->store(key, skeleton, (ofGetElapsedTimeMicros() - start) / 1000.0);
+		}
+	} else {
+		applyPose();
+	}
+	publishSnapshot();
+}
+
+void ofxSkeletonAnimation::applyPose () {
+	{
+		OFX_SPINE_TIMER(&stats, applyTime);
+		spAnimationState_apply(state, skeleton);
+	}
+	{
+		OFX_SPINE_TIMER(&stats, worldTransformTime);
+		spSkeleton_updateWorldTransform(skeleton);
+	}
+}
+
+/* Applies the timelines of one animation that change slots, with spAnimation_apply's looping. */
+static void applySlotTimelines (spSkeleton* skeleton, const spAnimation* animation, int loop, float lastTime, float time, float alpha) {
+	if (loop && animation->duration) {
+		time = FMOD(time, animation->duration);
+		lastTime = FMOD(lastTime, animation->duration);
+	}
+	for (int i = 0; i < animation->timelinesCount; ++i) {
+		spTimeline* timeline = animation->timelines[i];
+		switch (timeline->type) {
+		case SP_TIMELINE_COLOR:
+		case SP_TIMELINE_ATTACHMENT:
+		case SP_TIMELINE_FFD:
+		case SP_TIMELINE_DRAWORDER:
+			spTimeline_apply(timeline, skeleton, lastTime, time, 0, 0, alpha);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/* The part of spAnimationState_apply the pose cache does not share: slot colors, attachments, FFD and draw order, applied on
+ * top of this instance's own slots so per-instance attachments, skins and colors are kept. Mixes like spAnimationState_apply:
+ * the previous entry at full weight, then the current one by the mix alpha. */
+void ofxSkeletonAnimation::applySlots () {
+	for (int i = 0; i < state->tracksCount; ++i) {
+		spTrackEntry* current = state->tracks[i];
+		if (!current) continue;
+
+		float time = current->time;
+		if (!current->loop && time > current->endTime) time = current->endTime;
+
+		float alpha = current->mix;
+		spTrackEntry* previous = current->previous;
+		if (previous) {
+			float previousTime = previous->time;
+			if (!previous->loop && previousTime > previous->endTime) previousTime = previous->endTime;
+			applySlotTimelines(skeleton, previous->animation, previous->loop, previousTime, previousTime, 1);
+			alpha = min(current->mixTime / current->mixDuration * current->mix, 1.0f);
+		}
+		applySlotTimelines(skeleton, current->animation, current->loop, current->lastTime, time, alpha);
+	}
+}
+
+/* Everything spAnimationState_apply does besides posing the skeleton: fires events and completion, drops finished mixes and
+ * advances lastTime. Used when the pose comes from the pose cache. */
+void ofxSkeletonAnimation::applyEvents () {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, state);
+	for (int i = 0; i < state->tracksCount; ++i) {
+		spTrackEntry* current = state->tracks[i];
+		if (!current) continue;
+
+		float time = current->time;
+		if (!current->loop && time > current->endTime) time = current->endTime;
+
+		if (current->previous) {
+			float alpha = current->mixTime / current->mixDuration * current->mix;
+			if (alpha >= 1) {
+				internal->disposeTrackEntry(current->previous);
+				current->previous = 0;
+			}
+		}
+
+		int eventsCount = 0;
+		spAnimation* animation = current->animation;
+		float lastTime = current->lastTime, eventTime = time;
+		if (current->loop && animation->duration) {
+			eventTime = FMOD(eventTime, animation->duration);
+			lastTime = FMOD(lastTime, animation->duration);
+		}
+		for (int ii = 0; ii < animation->timelinesCount; ++ii) {
+			spTimeline* timeline = animation->timelines[ii];
+			if (timeline->type != SP_TIMELINE_EVENT) continue;
+			size_t capacity = eventsCount + ((spEventTimeline*)timeline)->framesCount;
+			if (firedEvents.size() < capacity) firedEvents.resize(capacity);
+			spTimeline_apply(timeline, skeleton, lastTime, eventTime, firedEvents.data(), &eventsCount, 1);
+		}
+
+		bool entryChanged = false;
+		for (int ii = 0; ii < eventsCount && !entryChanged; ++ii) {
+			spEvent* event = firedEvents[ii];
+			if (current->listener) {
+				current->listener(state, i, SP_ANIMATION_EVENT, event, 0);
+				if (state->tracks[i] != current) entryChanged = true;
+			}
+			if (!entryChanged && state->listener) {
+				state->listener(state, i, SP_ANIMATION_EVENT, event, 0);
+				if (state->tracks[i] != current) entryChanged = true;
+			}
+		}
+		if (entryChanged) continue;
+
+		// Check if completed the animation or a loop iteration.
+		if (current->loop ? (FMOD(current->lastTime, current->endTime) > FMOD(time, current->endTime))
+			: (current->lastTime < current->endTime && time >= current->endTime)) {
+			int count = (int)(time / current->endTime);
+			if (current->listener) {
+				current->listener(state, i, SP_ANIMATION_COMPLETE, 0, count);
+				if (state->tracks[i] != current) continue;
+			}
+			if (state->listener) {
+				state->listener(state, i, SP_ANIMATION_COMPLETE, 0, count);
+				if (state->tracks[i] != current) continue;
+			}
+		}
+		current->lastTime = current->time;
+	}
 }
 
 void ofxSkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
@@ -109,6 +258,7 @@ spTrackEntry* ofxSkeletonAnimation::setAnimation (int trackIndex, const char* na
 		ofLogError("Spine: Animation not found: %s", name);
 		return 0;
 	}
+	if (lazyData) lazyData->load(animation);
 	return spAnimationState_setAnimation(state, trackIndex, animation, loop);
 }
 
@@ -118,6 +268,7 @@ spTrackEntry* ofxSkeletonAnimation::addAnimation (int trackIndex, const char* na
 		ofLogError("Spine: Animation not found: %s", name);
 		return 0;
 	}
+	if (lazyData) lazyData->load(animation);
 	return spAnimationState_addAnimation(state, trackIndex, animation, loop, delay);
 }
 
@@ -133,6 +284,97 @@ void ofxSkeletonAnimation::clearTrack (int trackIndex) {
 	spAnimationState_clearTrack(state, trackIndex);
 }
 
+spAnimation* ofxSkeletonAnimation::findAnimation (const char* name) const {
+	return spSkeletonData_findAnimation(skeleton->data, name);
+}
+
+int ofxSkeletonAnimation::findSlotIndex (const char* slotName) const {
+	return spSkeleton_findSlotIndex(skeleton, slotName);
+}
+
+static ofxSkeletonCommand makeCommand (ofxSkeletonCommand::Type type, int index) {
+	ofxSkeletonCommand command;
+	command.type = type;
+	command.index = index;
+	command.animation = 0;
+	command.toAnimation = 0;
+	command.attachment = 0;
+	command.loop = false;
+	command.time = 0;
+	return command;
+}
+
+bool ofxSkeletonAnimation::queueSetAnimation (int trackIndex, spAnimation* animation, bool loop) {
+	ofxSkeletonCommand command = makeCommand(ofxSkeletonCommand::SET_ANIMATION, trackIndex);
+	command.animation = animation;
+	command.loop = loop;
+	return queueCommand(command);
+}
+
+bool ofxSkeletonAnimation::queueAddAnimation (int trackIndex, spAnimation* animation, bool loop, float delay) {
+	ofxSkeletonCommand command = makeCommand(ofxSkeletonCommand::ADD_ANIMATION, trackIndex);
+	command.animation = animation;
+	command.loop = loop;
+	command.time = delay;
+	return queueCommand(command);
+}
+
+bool ofxSkeletonAnimation::queueSetMix (spAnimation* fromAnimation, spAnimation* toAnimation, float duration) {
+	ofxSkeletonCommand command = makeCommand(ofxSkeletonCommand::SET_MIX, 0);
+	command.animation = fromAnimation;
+	command.toAnimation = toAnimation;
+	command.time = duration;
+	return queueCommand(command);
+}
+
+bool ofxSkeletonAnimation::queueClearTrack (int trackIndex) {
+	return queueCommand(makeCommand(ofxSkeletonCommand::CLEAR_TRACK, trackIndex));
+}
+
+bool ofxSkeletonAnimation::queueClearTracks () {
+	return queueCommand(makeCommand(ofxSkeletonCommand::CLEAR_TRACKS, 0));
+}
+
+bool ofxSkeletonAnimation::queueSetAttachment (int slotIndex, spAttachment* attachment) {
+	ofxSkeletonCommand command = makeCommand(ofxSkeletonCommand::SET_ATTACHMENT, slotIndex);
+	command.attachment = attachment;
+	return queueCommand(command);
+}
+
+bool ofxSkeletonAnimation::queueCommand (const ofxSkeletonCommand& command) {
+	return commands.push(command);
+}
+
+void ofxSkeletonAnimation::applyCommands () {
+	ofxSkeletonCommand command;
+	while (commands.pop(command)) {
+		switch (command.type) {
+		case ofxSkeletonCommand::SET_ANIMATION:
+			if (command.animation && lazyData) lazyData->load(command.animation);
+			if (command.animation) spAnimationState_setAnimation(state, command.index, command.animation, command.loop);
+			break;
+		case ofxSkeletonCommand::ADD_ANIMATION:
+			if (command.animation && lazyData) lazyData->load(command.animation);
+			if (command.animation) spAnimationState_addAnimation(state, command.index, command.animation, command.loop, command.time);
+			break;
+		case ofxSkeletonCommand::SET_MIX:
+			if (command.animation && command.toAnimation)
+				spAnimationStateData_setMix(state->data, command.animation, command.toAnimation, command.time);
+			break;
+		case ofxSkeletonCommand::CLEAR_TRACK:
+			spAnimationState_clearTrack(state, command.index);
+			break;
+		case ofxSkeletonCommand::CLEAR_TRACKS:
+			spAnimationState_clearTracks(state);
+			break;
+		case ofxSkeletonCommand::SET_ATTACHMENT:
+			if (command.index >= 0 && command.index < skeleton->slotsCount)
+				spSlot_setAttachment(skeleton->slots[command.index], command.attachment);
+			break;
+		}
+	}
+}
+
 void ofxSkeletonAnimation::onAnimationStateEvent (int trackIndex, spEventType type, spEvent* event, int loopCount) {
 	switch (type) {
 	case SP_ANIMATION_START:
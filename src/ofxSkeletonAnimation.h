@@ -4,6 +4,9 @@
 #include <spine/spine.h>
 #include "ofMain.h"
 #include "ofxSkeletonRenderer.h"
+#include "ofxSpineQueue.h"
+#include "ofxSkeletonPoseCache.h"
+#include "ofxSkeletonLazyData.h"
 
 namespace spine {
 	typedef std::function<void(int trackIndex)> StartListener;
@@ -12,6 +15,27 @@ namespace spine {
 	typedef std::function<void(int trackIndex, spEvent* event)> EventListener;
 }
 
+/** A deferred AnimationState or Skeleton change, see ofxSkeletonAnimation::queueSetAnimation. Handles are resolved up front
+  * so applying a command never looks up names. */
+struct ofxSkeletonCommand {
+	enum Type {
+		SET_ANIMATION,
+		ADD_ANIMATION,
+		SET_MIX,
+		CLEAR_TRACK,
+		CLEAR_TRACKS,
+		SET_ATTACHMENT
+	};
+
+	Type type;
+	int index; // Track index, or slot index for SET_ATTACHMENT.
+	spAnimation* animation; // From animation for SET_MIX.
+	spAnimation* toAnimation;
+	spAttachment* attachment;
+	bool loop;
+	float time; // Delay for ADD_ANIMATION, duration for SET_MIX.
+};
+
 
 /** Draws an animated skeleton, providing an AnimationState for applying one or more animations and queuing animations to be
   * played later. */
@@ -31,6 +55,15 @@ public:
 
 	virtual void update (float deltaTime);
 
+	/* Shares poses with other instances using the same cache, see ofxSkeletonPoseCache. May be 0 (default). */
+	void setPoseCache (shared_ptr<ofxSkeletonPoseCache> cache) { poseCache = cache; }
+	shared_ptr<ofxSkeletonPoseCache> getPoseCache () const { return poseCache; }
+
+	/* Loads animations of lazily loaded data on first use and marks the playing ones as used, see ofxSkeletonLazyData. Must be
+	 * the data this skeleton was created with. May be 0 (default). */
+	void setLazyData (shared_ptr<ofxSkeletonLazyData> data) { lazyData = data; }
+	shared_ptr<ofxSkeletonLazyData> getLazyData () const { return lazyData; }
+
 	void setAnimationStateData (spAnimationStateData* stateData);
 	void setMix (const char* fromAnimation, const char* toAnimation, float duration);
 
@@ -49,6 +82,25 @@ public:
 	void setCompleteListener (spTrackEntry* entry, spine::CompleteListener listener);
 	void setEventListener (spTrackEntry* entry, spine::EventListener listener);
 
+	// --- Thread-safe commands. The queue* methods may be called from any thread; the commands are applied in order at the
+	// start of the next update(). They return false if the queue is full.
+
+	/* Returns 0 if the animation was not found. Resolve handles once, before handing them to other threads. */
+	spAnimation* findAnimation (const char* name) const;
+	/* Returns -1 if the slot was not found. */
+	int findSlotIndex (const char* slotName) const;
+
+	bool queueSetAnimation (int trackIndex, spAnimation* animation, bool loop);
+	bool queueAddAnimation (int trackIndex, spAnimation* animation, bool loop, float delay = 0);
+	bool queueSetMix (spAnimation* fromAnimation, spAnimation* toAnimation, float duration);
+	bool queueClearTrack (int trackIndex = 0);
+	bool queueClearTracks ();
+	/* @param attachment May be 0 to clear the slot. */
+	bool queueSetAttachment (int slotIndex, spAttachment* attachment);
+	bool queueCommand (const ofxSkeletonCommand& command);
+	/* Applies all queued commands. Called by update(). */
+	void applyCommands ();
+
 	virtual void onAnimationStateEvent (int trackIndex, spEventType type, spEvent* event, int loopCount);
 	virtual void onTrackEntryEvent (int trackIndex, spEventType type, spEvent* event, int loopCount);
 
@@ -58,6 +110,14 @@ protected:
 private:
 	typedef ofxSkeletonRenderer super;
 	bool ownsAnimationStateData;
+	ofxSpineQueue<ofxSkeletonCommand> commands;
+	shared_ptr<ofxSkeletonPoseCache> poseCache;
+	shared_ptr<ofxSkeletonLazyData> lazyData;
+	vector<spEvent*> firedEvents;
+
+	void applyPose ();
+	void applySlots ();
+	void applyEvents ();
 
 	void initialize ();
 };
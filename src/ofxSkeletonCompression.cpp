@@ -0,0 +1,324 @@
+#include "ofxSkeletonCompression.h"
+#include "ofxSkeletonLazyData.h"
+
+#include <spine/extension.h>
+
+static const int CURVE_STEPPED = 1, CURVE_BEZIER = 2, BEZIER_SIZE = 19;
+
+typedef struct {
+	spTimeline super;
+	int index; // Bone or slot.
+	int channels;
+	int keysCount;
+	float timeStep;
+	float offsets[4];
+	float scales[4];
+	uint16_t* times; // keysCount times, then keysCount * channels values, in one allocation.
+	uint16_t* values;
+} ofxCompressedTimeline;
+
+ofxSkeletonCompression::Settings::Settings()
+	: rotationTolerance(0.05f), translateTolerance(0.05f), scaleTolerance(0.0005f), colorTolerance(0.002f), curveSamples(10) {
+}
+
+ofxSkeletonCompression::Report::Report()
+	: timelines(0), keysBefore(0), keysAfter(0), bytesBefore(0), bytesAfter(0) {
+}
+
+ofxSkeletonCompression::Report& ofxSkeletonCompression::Report::operator+= (const Report& other) {
+	timelines += other.timelines;
+	keysBefore += other.keysBefore;
+	keysAfter += other.keysAfter;
+	bytesBefore += other.bytesBefore;
+	bytesAfter += other.bytesAfter;
+	return *this;
+}
+
+static void compressedDispose (spTimeline* timeline) {
+	ofxCompressedTimeline* self = SUB_CAST(ofxCompressedTimeline, timeline);
+	_spTimeline_deinit(timeline);
+	FREE(self->times);
+	FREE(self);
+}
+
+/* Returns false before the first key, like the spine timelines which leave the skeleton untouched there. */
+static bool sample (const ofxCompressedTimeline* self, float time, float* out) {
+	const uint16_t* times = self->times;
+	// Compared rounded like the key times, so a time landing on a key finds the same key as the float timelines.
+	float q = time / self->timeStep, rounded = floorf(q + 0.5f);
+	if (rounded < times[0]) return false;
+
+	int last = self->keysCount - 1, channels = self->channels;
+	if (rounded >= times[last]) {
+		for (int c = 0; c < channels; ++c) out[c] = self->offsets[c] + self->values[last * channels + c] * self->scales[c];
+		return true;
+	}
+	// First key after the time.
+	int low = 1, high = last;
+	while (low < high) {
+		int middle = (low + high) >> 1;
+		if (times[middle] > rounded) high = middle;
+		else low = middle + 1;
+	}
+	int prev = low - 1;
+	float percent = max(0.0f, min(1.0f, (q - times[prev]) / (times[low] - times[prev])));
+	const uint16_t* from = self->values + prev * channels;
+	const uint16_t* to = from + channels;
+	for (int c = 0; c < channels; ++c)
+		out[c] = self->offsets[c] + (from[c] + (to[c] - (float)from[c]) * percent) * self->scales[c];
+	return true;
+}
+
+static float wrapDegrees (float amount) {
+	while (amount > 180) amount -= 360;
+	while (amount < -180) amount += 360;
+	return amount;
+}
+
+static void compressedApply (const spTimeline* timeline, spSkeleton* skeleton, float, float time, spEvent**, int*, float alpha)
+{
+	const ofxCompressedTimeline* self = SUB_CAST(ofxCompressedTimeline, timeline);
+	float v[4];
+	if (!sample(self, time, v)) return;
+	switch (timeline->type) {
+	case SP_TIMELINE_ROTATE: {
+		spBone* bone = skeleton->bones[self->index];
+		bone->rotation += wrapDegrees(bone->data->rotation + v[0] - bone->rotation) * alpha;
+		break;
+	}
+	case SP_TIMELINE_TRANSLATE: {
+		spBone* bone = skeleton->bones[self->index];
+		bone->x += (bone->data->x + v[0] - bone->x) * alpha;
+		bone->y += (bone->data->y + v[1] - bone->y) * alpha;
+		break;
+	}
+	case SP_TIMELINE_SCALE: {
+		spBone* bone = skeleton->bones[self->index];
+		bone->scaleX += (bone->data->scaleX * v[0] - bone->scaleX) * alpha;
+		bone->scaleY += (bone->data->scaleY * v[1] - bone->scaleY) * alpha;
+		break;
+	}
+	case SP_TIMELINE_COLOR: {
+		spSlot* slot = skeleton->slots[self->index];
+		if (alpha < 1) {
+			slot->r += (v[0] - slot->r) * alpha;
+			slot->g += (v[1] - slot->g) * alpha;
+			slot->b += (v[2] - slot->b) * alpha;
+			slot->a += (v[3] - slot->a) * alpha;
+		} else {
+			slot->r = v[0];
+			slot->g = v[1];
+			slot->b = v[2];
+			slot->a = v[3];
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+bool ofxSkeletonCompression::isCompressed (const spTimeline* timeline) {
+	return VTABLE(spTimeline, timeline)->dispose == compressedDispose;
+}
+
+size_t ofxSkeletonCompression::getCompressedBytes (const spTimeline* timeline) {
+	if (!isCompressed(timeline)) return 0;
+	const ofxCompressedTimeline* self = SUB_CAST(ofxCompressedTimeline, timeline);
+	return sizeof(ofxCompressedTimeline) + self->keysCount * (1 + self->channels) * sizeof(uint16_t);
+}
+
+/* Linear keys: times and values (channels per key), plus which keys must survive the reduction. */
+struct Keys
+{
+	int channels;
+	vector<float> times;
+	vector<float> values;
+	vector<bool> fixed;
+
+	void add (float time, const float* value, bool keep) {
+		times.push_back(time);
+		values.insert(values.end(), value, value + channels);
+		fixed.push_back(keep);
+	}
+};
+
+/* Bakes the curves of a spine timeline into linear keys. Stepped segments become two keys at the next key's time. */
+static void bake (const spCurveTimeline* timeline, const float* frames, int framesCount, int frameSize, bool rotation,
+	int curveSamples, Keys& keys)
+{
+	int count = framesCount / frameSize, channels = keys.channels;
+	vector<float> unwrapped(count * channels);
+	for (int i = 0; i < count; ++i) {
+		for (int c = 0; c < channels; ++c) {
+			float value = frames[i * frameSize + 1 + c];
+			// Store rotations continuously so linear interpolation takes the same shortest path as the rotate timeline.
+			if (rotation && i > 0) value = unwrapped[(i - 1) * channels + c] + wrapDegrees(value - frames[(i - 1) * frameSize + 1 + c]);
+			unwrapped[i * channels + c] = value;
+		}
+	}
+	float value[4];
+	for (int i = 0; i < count; ++i) {
+		const float* from = &unwrapped[i * channels];
+		float time = frames[i * frameSize];
+		bool last = i == count - 1;
+		float curveType = last ? 0 : timeline->curves[i * BEZIER_SIZE];
+		keys.add(time, from, i == 0 || last || curveType == CURVE_STEPPED);
+		if (last) break;
+
+		const float* to = from + channels;
+		float nextTime = frames[(i + 1) * frameSize];
+		if (curveType == CURVE_STEPPED) {
+			keys.add(nextTime, from, true);
+			// The next key is fixed too so the pair keeps its shared time.
+			continue;
+		}
+		if (curveType == CURVE_BEZIER) {
+			for (int s = 1; s < curveSamples; ++s) {
+				float percent = s / (float)curveSamples;
+				float curved = spCurveTimeline_getCurvePercent(timeline, i, percent);
+				for (int c = 0; c < channels; ++c) value[c] = from[c] + (to[c] - from[c]) * curved;
+				keys.add(time + (nextTime - time) * percent, value, false);
+			}
+		}
+	}
+	// Keys right after a stepped pair start a new segment.
+	for (size_t i = 1; i < keys.times.size(); ++i)
+		if (keys.times[i] == keys.times[i - 1]) {
+			keys.fixed[i] = true;
+			keys.fixed[i - 1] = true;
+		}
+}
+
+/* Drops keys the interpolation of their kept neighbors reproduces within the tolerance. Returns the kept key indices. */
+static vector<int> reduce (const Keys& keys, float tolerance) {
+	vector<int> kept;
+	int count = keys.times.size(), channels = keys.channels;
+	if (!count) return kept;
+	kept.push_back(0);
+	int anchor = 0;
+	for (int end = 1; end < count; ++end) {
+		if (keys.fixed[end] || end == count - 1) {
+			// anchor..end was checked when testing end - 1.
+			kept.push_back(end);
+			anchor = end;
+			continue;
+		}
+		// Can anchor..end+1 skip end and every key skipped before it?
+		int next = end + 1;
+		float span = keys.times[next] - keys.times[anchor];
+		bool fits = span > 0;
+		for (int k = anchor + 1; fits && k < next; ++k) {
+			float percent = (keys.times[k] - keys.times[anchor]) / span;
+			for (int c = 0; c < channels; ++c) {
+				float from = keys.values[anchor * channels + c], to = keys.values[next * channels + c];
+				if (fabsf(from + (to - from) * percent - keys.values[k * channels + c]) > tolerance) {
+					fits = false;
+					break;
+				}
+			}
+		}
+		if (!fits) {
+			kept.push_back(end);
+			anchor = end;
+		}
+	}
+	return kept;
+}
+
+/* Returns 0 if the timeline has no keys. */
+static ofxCompressedTimeline* quantize (spTimelineType type, int index, const Keys& keys, const vector<int>& kept) {
+	int count = kept.size(), channels = keys.channels;
+	if (!count) return 0;
+
+	ofxCompressedTimeline* self = NEW(ofxCompressedTimeline);
+	_spTimeline_init(SUPER(self), type, compressedDispose, compressedApply);
+	self->index = index;
+	self->channels = channels;
+	self->keysCount = count;
+	self->times = MALLOC(uint16_t, count * (1 + channels));
+	self->values = self->times + count;
+
+	float lastTime = keys.times[kept[count - 1]];
+	self->timeStep = lastTime > 0 ? lastTime / 65535 : 1;
+	for (int i = 0; i < count; ++i)
+		self->times[i] = (uint16_t)min(65535.0f, floorf(keys.times[kept[i]] / self->timeStep + 0.5f));
+
+	for (int c = 0; c < channels; ++c) {
+		float low = FLT_MAX, high = -FLT_MAX;
+		for (int i = 0; i < count; ++i) {
+			float value = keys.values[kept[i] * channels + c];
+			low = min(low, value);
+			high = max(high, value);
+		}
+		self->offsets[c] = low;
+		self->scales[c] = high > low ? (high - low) / 65535 : 0;
+		for (int i = 0; i < count; ++i) {
+			float value = keys.values[kept[i] * channels + c];
+			self->values[i * channels + c] = self->scales[c] ? (uint16_t)floorf((value - low) / self->scales[c] + 0.5f) : 0;
+		}
+	}
+	return self;
+}
+
+ofxSkeletonCompression::Report ofxSkeletonCompression::compress (spAnimation* animation, const Settings& settings) {
+	Report report;
+	report.bytesBefore = ofxSkeletonLazyData::getAnimationBytes(animation);
+	for (int i = 0; i < animation->timelinesCount; ++i) {
+		spTimeline* timeline = animation->timelines[i];
+		if (isCompressed(timeline)) continue;
+
+		Keys keys;
+		float tolerance;
+		int index;
+		switch (timeline->type) {
+		case SP_TIMELINE_ROTATE:
+		case SP_TIMELINE_TRANSLATE:
+		case SP_TIMELINE_SCALE: {
+			spBaseTimeline* base = (spBaseTimeline*)timeline;
+			bool rotation = timeline->type == SP_TIMELINE_ROTATE;
+			keys.channels = rotation ? 1 : 2;
+			bake(SUPER(base), base->frames, base->framesCount, keys.channels + 1, rotation, settings.curveSamples, keys);
+			tolerance = rotation ? settings.rotationTolerance
+				: timeline->type == SP_TIMELINE_TRANSLATE ? settings.translateTolerance : settings.scaleTolerance;
+			index = base->boneIndex;
+			break;
+		}
+		case SP_TIMELINE_COLOR: {
+			spColorTimeline* color = (spColorTimeline*)timeline;
+			keys.channels = 4;
+			bake(SUPER(color), color->frames, color->framesCount, 5, false, settings.curveSamples, keys);
+			tolerance = settings.colorTolerance;
+			index = color->slotIndex;
+			break;
+		}
+		default:
+			continue;
+		}
+
+		vector<int> kept = reduce(keys, tolerance);
+		ofxCompressedTimeline* compressed = quantize(timeline->type, index, keys, kept);
+		if (!compressed) continue;
+		size_t before = ofxSkeletonLazyData::getTimelineBytes(timeline);
+		size_t after = getCompressedBytes(SUPER(compressed));
+		if (after >= before) {
+			spTimeline_dispose(SUPER(compressed));
+			continue;
+		}
+		report.timelines++;
+		report.keysBefore += timeline->type == SP_TIMELINE_COLOR ? ((spColorTimeline*)timeline)->framesCount / 5
+			: ((spBaseTimeline*)timeline)->framesCount / (timeline->type == SP_TIMELINE_ROTATE ? 2 : 3);
+		report.keysAfter += compressed->keysCount;
+		spTimeline_dispose(timeline);
+		animation->timelines[i] = SUPER(compressed);
+	}
+	report.bytesAfter = ofxSkeletonLazyData::getAnimationBytes(animation);
+	return report;
+}
+
+ofxSkeletonCompression::Report ofxSkeletonCompression::compress (spSkeletonData* skeletonData, const Settings& settings) {
+	Report report;
+	for (int i = 0; i < skeletonData->animationsCount; ++i)
+		report += compress(skeletonData->animations[i], settings);
+	return report;
+}
@@ -0,0 +1,47 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+
+/** Optional pass run after loading that shrinks rotate, translate, scale and color timelines. Bezier curves are baked into
+  * linear keys, keys within the tolerances of their neighbors' interpolation are dropped, and the remaining times and values
+  * are quantized to 16 bits in one contiguous block per timeline, which replaces the float frames and the 19 curve floats per
+  * key. Stepped keys are kept exact. A compressed timeline is only kept when it is smaller than the original.
+  *
+  * Compressed timelines keep their spTimelineType but are not spBaseTimeline / spColorTimeline: check isCompressed() before
+  * casting. Apply the pass before creating instances, or at least while none of them is updating. */
+class ofxSkeletonCompression
+{
+public:
+
+	struct Settings
+	{
+		float rotationTolerance; // Degrees.
+		float translateTolerance; // Skeleton units.
+		float scaleTolerance;
+		float colorTolerance; // 0-1 per channel.
+		int curveSamples; // Linear keys per bezier segment before reduction.
+
+		Settings();
+	};
+
+	struct Report
+	{
+		int timelines; // Compressed.
+		int keysBefore;
+		int keysAfter;
+		size_t bytesBefore; // Of the whole animations, see ofxSkeletonLazyData::getAnimationBytes.
+		size_t bytesAfter;
+
+		Report();
+		Report& operator+= (const Report& other);
+	};
+
+	static Report compress (spSkeletonData* skeletonData, const Settings& settings = Settings());
+	static Report compress (spAnimation* animation, const Settings& settings = Settings());
+
+	static bool isCompressed (const spTimeline* timeline);
+	/* Bytes of a compressed timeline, or 0 if it is not compressed. */
+	static size_t getCompressedBytes (const spTimeline* timeline);
+};
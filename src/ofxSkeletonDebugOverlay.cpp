@@ -0,0 +1,147 @@
+#include "ofxSkeletonDebugOverlay.h"
+
+shared_ptr<ofxSkeletonDebugOverlay> ofxSkeletonDebugOverlay::create () {
+	return make_shared<ofxSkeletonDebugOverlay>();
+}
+
+ofxSkeletonDebugOverlay::ofxSkeletonDebugOverlay()
+	: drawSlots(true), drawMeshes(true), drawBones(true), drawOrigins(true),
+	lineWidth(1), pointSize(8),
+	slotColor(0, 0, 255), meshColor(255, 255, 0, 128), boneColor(255, 0, 0), rootColor(0, 0, 255), originColor(0, 255, 0),
+	worldVertices(1000) // Max number of vertices per mesh.
+{
+	lines.setMode(OF_PRIMITIVE_LINES);
+	points.setMode(OF_PRIMITIVE_POINTS);
+}
+
+int ofxSkeletonDebugOverlay::getCategories (int categories) const {
+	int flags = (drawSlots ? SLOTS : 0) | (drawMeshes ? MESHES : 0) | (drawBones ? BONES : 0) | (drawOrigins ? ORIGINS : 0);
+	return categories & flags;
+}
+
+void ofxSkeletonDebugOverlay::add (const spSkeleton* skeleton, const ofMatrix4x4& transform, int categories) {
+	categories = getCategories(categories);
+	if (categories & (SLOTS | MESHES)) {
+		for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
+			spSlot* slot = skeleton->drawOrder[i];
+			if (!slot->attachment) continue;
+			switch (slot->attachment->type) {
+			case SP_ATTACHMENT_REGION:
+				if (!(categories & SLOTS)) continue;
+				spRegionAttachment_computeWorldVertices((spRegionAttachment*)slot->attachment, slot->bone, worldVertices.data());
+				break;
+			case SP_ATTACHMENT_MESH:
+				if (!(categories & MESHES)) continue;
+				spMeshAttachment_computeWorldVertices((spMeshAttachment*)slot->attachment, slot, worldVertices.data());
+				break;
+			case SP_ATTACHMENT_WEIGHTED_MESH:
+				if (!(categories & MESHES)) continue;
+				spWeightedMeshAttachment_computeWorldVertices((spWeightedMeshAttachment*)slot->attachment, slot, worldVertices.data());
+				break;
+			default:
+				continue;
+			}
+			addSlot(slot->attachment, worldVertices.data(), transform);
+		}
+	}
+	if (categories & (BONES | ORIGINS)) {
+		for (int i = 0, n = skeleton->bonesCount; i < n; i++) {
+			spBone* bone = skeleton->bones[i];
+			addBone(skeleton->x + bone->worldX, skeleton->y + bone->worldY, bone->a, bone->c, bone->data->length, i == 0, transform,
+				categories);
+		}
+	}
+}
+
+void ofxSkeletonDebugOverlay::add (const ofxSkeletonPose& pose, const ofMatrix4x4& transform, int categories) {
+	if (!pose.data) return;
+	categories = getCategories(categories);
+	if (categories & (SLOTS | MESHES)) {
+		for (size_t i = 0; i < pose.drawOrder.size(); i++) {
+			int slotIndex = pose.drawOrder[i];
+			spAttachment* attachment = pose.slots[slotIndex].attachment;
+			if (!attachment) continue;
+			bool region = attachment->type == SP_ATTACHMENT_REGION;
+			if (!(categories & (region ? SLOTS : MESHES))) continue;
+			if (!pose.computeWorldVertices(slotIndex, worldVertices.data())) continue;
+			addSlot(attachment, worldVertices.data(), transform);
+		}
+	}
+	if (categories & (BONES | ORIGINS)) {
+		for (size_t i = 0; i < pose.bones.size(); i++) {
+			const ofxSkeletonPose::Bone& bone = pose.bones[i];
+			addBone(pose.x + bone.worldX, pose.y + bone.worldY, bone.a, bone.c, pose.data->bones[i]->length, i == 0, transform,
+				categories);
+		}
+	}
+}
+
+void ofxSkeletonDebugOverlay::addSlot (spAttachment* attachment, const float* vertices, const ofMatrix4x4& transform) {
+	const int* triangles;
+	int trianglesCount;
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION: {
+		ofVec3f corners[4];
+		for (int i = 0; i < 4; ++i) corners[i] = transform.preMult(ofVec3f(vertices[i * 2], vertices[i * 2 + 1]));
+		for (int i = 0; i < 4; ++i) addLine(corners[i], corners[(i + 1) % 4], slotColor);
+		return;
+	}
+	case SP_ATTACHMENT_MESH:
+		triangles = ((spMeshAttachment*)attachment)->triangles;
+		trianglesCount = ((spMeshAttachment*)attachment)->trianglesCount;
+		break;
+	case SP_ATTACHMENT_WEIGHTED_MESH:
+		triangles = ((spWeightedMeshAttachment*)attachment)->triangles;
+		trianglesCount = ((spWeightedMeshAttachment*)attachment)->trianglesCount;
+		break;
+	default:
+		return;
+	}
+	for (int i = 0; i < trianglesCount; i += 3) {
+		ofVec3f corners[3];
+		for (int ii = 0; ii < 3; ++ii) {
+			int index = triangles[i + ii] << 1;
+			corners[ii] = transform.preMult(ofVec3f(vertices[index], vertices[index + 1]));
+		}
+		addLine(corners[0], corners[1], meshColor);
+		addLine(corners[1], corners[2], meshColor);
+		addLine(corners[2], corners[0], meshColor);
+	}
+}
+
+void ofxSkeletonDebugOverlay::addBone (float worldX, float worldY, float a, float c, float length, bool root, const ofMatrix4x4& transform,
+	int categories) {
+	ofVec3f origin = transform.preMult(ofVec3f(worldX, worldY));
+	if (categories & BONES) addLine(origin, transform.preMult(ofVec3f(worldX + length * a, worldY + length * c)), boneColor);
+	if (categories & ORIGINS) {
+		points.addVertex(origin);
+		points.addColor(root ? rootColor : originColor);
+	}
+}
+
+void ofxSkeletonDebugOverlay::addLine (const ofVec3f& from, const ofVec3f& to, const ofFloatColor& color) {
+	lines.addVertex(from);
+	lines.addVertex(to);
+	lines.addColor(color);
+	lines.addColor(color);
+}
+
+void ofxSkeletonDebugOverlay::draw () {
+	if (lines.getNumVertices()) {
+		ofSetLineWidth(lineWidth);
+		lines.draw();
+	}
+	if (points.getNumVertices()) {
+		glPointSize(pointSize);
+		points.draw();
+	}
+	ofSetColor(255);
+	clear();
+}
+
+void ofxSkeletonDebugOverlay::clear () {
+	lines.clear();
+	points.clear();
+	lines.setMode(OF_PRIMITIVE_LINES);
+	points.setMode(OF_PRIMITIVE_POINTS);
+}
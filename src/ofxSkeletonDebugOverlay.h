@@ -0,0 +1,62 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include "ofxSkeletonPose.h"
+
+/** Collects debug geometry of many skeletons into one line mesh and one point mesh, drawn with two draw calls. Share one
+  * overlay between renderers (ofxSkeletonRenderer::setDebugOverlay) and call draw() once per frame after drawing them. */
+class ofxSkeletonDebugOverlay
+{
+public:
+	/* Categories for add(). */
+	enum
+	{
+		SLOTS = 1,
+		MESHES = 2,
+		BONES = 4,
+		ORIGINS = 8,
+		ALL = SLOTS | MESHES | BONES | ORIGINS
+	};
+
+	bool drawSlots;   // Region attachment quads.
+	bool drawMeshes;  // Mesh wireframes.
+	bool drawBones;   // Bone lengths.
+	bool drawOrigins; // Bone origins.
+
+	float lineWidth;
+	float pointSize;
+
+	ofColor slotColor;
+	ofColor meshColor;
+	ofColor boneColor;
+	ofColor rootColor;
+	ofColor originColor;
+
+	static shared_ptr<ofxSkeletonDebugOverlay> create ();
+
+	ofxSkeletonDebugOverlay();
+
+	/* @param transform Applied to the skeleton's world coordinates.
+	 * @param categories What this skeleton wants drawn; only those the draw* flags also allow are added. */
+	void add (const spSkeleton* skeleton, const ofMatrix4x4& transform = ofMatrix4x4(), int categories = ALL);
+	void add (const ofxSkeletonPose& pose, const ofMatrix4x4& transform = ofMatrix4x4(), int categories = ALL);
+
+	/* Draws and clears everything added since the last draw. */
+	void draw ();
+	void clear ();
+
+	bool isEmpty () const { return lines.getNumVertices() == 0 && points.getNumVertices() == 0; }
+
+private:
+	void addSlot (spAttachment* attachment, const float* worldVertices, const ofMatrix4x4& transform);
+	void addBone (float worldX, float worldY, float a, float c, float length, bool root, const ofMatrix4x4& transform,
+		int categories);
+	int getCategories (int categories) const;
+	void addLine (const ofVec3f& from, const ofVec3f& to, const ofFloatColor& color);
+
+	ofMesh lines;
+	ofMesh points;
+	vector<float> worldVertices;
+};
@@ -0,0 +1,36 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+
+/** Attachments of one or more skeletons in draw order, with their vertices already transformed, filled by
+  * ofxSkeletonRenderer::collect() instead of drawing. */
+struct ofxSkeletonDrawList
+{
+	struct Item
+	{
+		ofTexture* texture;
+		GLuint blendSrc, blendDst;
+		const float* uvs;
+		int verticesCount; // Floats, two per vertex.
+		const int* triangles;
+		int trianglesCount;
+		int verticesOffset; // Into vertices.
+		ofColor color;
+		ofRectangle bounds;
+		int tag; // Set by the caller of collect(), e.g. the instance index.
+	};
+
+	vector<Item> items;
+	vector<float> vertices;
+
+	void clear () {
+		items.clear();
+		vertices.clear();
+	}
+
+	/* Attachments that can be drawn in one batch. */
+	static bool canBatch (const Item& a, const Item& b) {
+		return a.texture == b.texture && a.blendSrc == b.blendSrc && a.blendDst == b.blendDst;
+	}
+};
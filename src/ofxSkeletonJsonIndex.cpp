@@ -0,0 +1,136 @@
+#include "ofxSkeletonJsonIndex.h"
+
+#include <spine/extension.h>
+
+size_t ofxSkeletonJsonIndex::skipSpace (const char* json, size_t length, size_t begin) {
+	while (begin < length && (json[begin] == ' ' || json[begin] == '\t' || json[begin] == '\n' || json[begin] == '\r'))
+		begin++;
+	return begin;
+}
+
+/* Returns the index one past the closing quote of the string starting at json[begin]. */
+static size_t skipString (const char* json, size_t length, size_t begin) {
+	for (size_t i = begin + 1; i < length; ++i) {
+		if (json[i] == '\\') i++;
+		else if (json[i] == '"') return i + 1;
+	}
+	return 0;
+}
+
+size_t ofxSkeletonJsonIndex::skipValue (const char* json, size_t length, size_t begin) {
+	if (begin >= length) return 0;
+	char c = json[begin];
+	if (c == '"') return skipString(json, length, begin);
+	if (c != '{' && c != '[') {
+		// Number, true, false or null.
+		size_t i = begin;
+		while (i < length && json[i] != ',' && json[i] != '}' && json[i] != ']' && json[i] != ' ' && json[i] != '\t'
+			&& json[i] != '\n' && json[i] != '\r')
+			i++;
+		return i > begin ? i : 0;
+	}
+	int depth = 0;
+	for (size_t i = begin; i < length; ++i) {
+		switch (json[i]) {
+		case '"':
+			i = skipString(json, length, i);
+			if (!i) return 0;
+			i--;
+			break;
+		case '{':
+		case '[':
+			depth++;
+			break;
+		case '}':
+		case ']':
+			if (--depth == 0) return i + 1;
+			break;
+		}
+	}
+	return 0;
+}
+
+bool ofxSkeletonJsonIndex::containsKey (const char* json, size_t begin, size_t end, const char* name) {
+	string key = string("\"") + name + "\"";
+	const char* found = std::search(json + begin, json + end, key.begin(), key.end());
+	while (found != json + end) {
+		size_t next = skipSpace(json, end, found - json + key.size());
+		if (next < end && json[next] == ':') return true;
+		found = std::search(found + 1, json + end, key.begin(), key.end());
+	}
+	return false;
+}
+
+bool ofxSkeletonJsonIndex::index (const char* json, size_t length, size_t begin) {
+	members.clear();
+	end = 0;
+	size_t i = skipSpace(json, length, begin);
+	if (i >= length || json[i] != '{') {
+		ofLogError("ofxSkeletonJsonIndex") << "Expected an object at " << i;
+		return false;
+	}
+	i = skipSpace(json, length, i + 1);
+	while (i < length && json[i] != '}') {
+		Member member;
+		member.begin = i;
+		size_t keyEnd = json[i] == '"' ? skipString(json, length, i) : 0;
+		if (!keyEnd) {
+			ofLogError("ofxSkeletonJsonIndex") << "Expected a key at " << i;
+			return false;
+		}
+		for (size_t ii = i + 1; ii < keyEnd - 1; ++ii) {
+			if (json[ii] == '\\') ii++;
+			member.name += json[ii];
+		}
+		i = skipSpace(json, length, keyEnd);
+		if (i >= length || json[i] != ':') {
+			ofLogError("ofxSkeletonJsonIndex") << "Expected ':' at " << i;
+			return false;
+		}
+		member.valueBegin = skipSpace(json, length, i + 1);
+		member.end = skipValue(json, length, member.valueBegin);
+		if (!member.end) {
+			ofLogError("ofxSkeletonJsonIndex") << "Malformed value of '" << member.name << "' at " << member.valueBegin;
+			return false;
+		}
+		members.push_back(member);
+		i = skipSpace(json, length, member.end);
+		if (i < length && json[i] == ',') i = skipSpace(json, length, i + 1);
+	}
+	if (i >= length) {
+		ofLogError("ofxSkeletonJsonIndex") << "Unterminated object";
+		return false;
+	}
+	end = i + 1;
+	return true;
+}
+
+const ofxSkeletonJsonIndex::Member* ofxSkeletonJsonIndex::find (const string& name) const {
+	for (size_t i = 0; i < members.size(); ++i)
+		if (members[i].name == name) return &members[i];
+	return 0;
+}
+
+void ofxSkeletonJsonIndex::remap (spAnimation* animation, const spSkeletonData* parsedData, spSkeletonData* skeletonData) {
+	for (int i = 0; i < animation->timelinesCount; ++i) {
+		spTimeline* timeline = animation->timelines[i];
+		if (timeline->type == SP_TIMELINE_EVENT) {
+			spEventTimeline* events = (spEventTimeline*)timeline;
+			for (int ii = 0; ii < events->framesCount; ++ii) {
+				spEvent* event = events->events[ii];
+				CONST_CAST(spEventData*, event->data) = spSkeletonData_findEvent(skeletonData, event->data->name);
+			}
+		} else if (timeline->type == SP_TIMELINE_FFD) {
+			spFFDTimeline* ffd = (spFFDTimeline*)timeline;
+			spAttachment* attachment = 0;
+			for (int ii = 0; ii < parsedData->skinsCount && !attachment; ++ii) {
+				spSkin* skin = parsedData->skins[ii];
+				if (spSkin_getAttachment(skin, ffd->slotIndex, ffd->attachment->name) != ffd->attachment) continue;
+				spSkin* ownSkin = spSkeletonData_findSkin(skeletonData, skin->name);
+				if (ownSkin) attachment = spSkin_getAttachment(ownSkin, ffd->slotIndex, ffd->attachment->name);
+			}
+			if (!attachment) ofLogWarning("ofxSkeletonJsonIndex") << "FFD attachment not found: " << ffd->attachment->name;
+			ffd->attachment = attachment;
+		}
+	}
+}
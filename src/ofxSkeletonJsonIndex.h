@@ -0,0 +1,42 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+
+/** Byte ranges of the members of a skeleton JSON object, found without building a document tree. Used to cut a skeleton
+  * file into smaller documents that spSkeletonJson can parse on their own (lazy and parallel loading). Only the structure is
+  * checked; values are left to spSkeletonJson. */
+class ofxSkeletonJsonIndex
+{
+public:
+
+	struct Member
+	{
+		string name;
+		size_t begin; // Opening quote of the key.
+		size_t valueBegin;
+		size_t end; // One past the value.
+	};
+
+	/* Indexes the members of the object starting at json[begin], or the top level object if begin is 0. Returns false and
+	 * logs if the JSON is malformed. */
+	bool index (const char* json, size_t length, size_t begin = 0);
+
+	/* Returns 0 if there is no such member. */
+	const Member* find (const string& name) const;
+
+	vector<Member> members;
+	/* One past the closing brace of the indexed object. */
+	size_t end;
+
+	/* Returns the index one past the value starting at json[begin], or 0 if the value is malformed. */
+	static size_t skipValue (const char* json, size_t length, size_t begin);
+	static size_t skipSpace (const char* json, size_t length, size_t begin);
+	/* True if the key "name" appears anywhere in json[begin, end). */
+	static bool containsKey (const char* json, size_t begin, size_t end, const char* name);
+
+	/* Points the events and FFD attachments of an animation parsed into parsedData, from a document cut out of a skeleton
+	 * file, at the ones of skeletonData, looked up by name. Both must come from the same file. */
+	static void remap (spAnimation* animation, const spSkeletonData* parsedData, spSkeletonData* skeletonData);
+};
@@ -0,0 +1,356 @@
+#include "ofxSkeletonLazyData.h"
+#include "ofxSkeletonJsonIndex.h"
+#include "ofxSkeletonCompression.h"
+#include "ofxSpineFileSource.h"
+
+#include <spine/extension.h>
+
+shared_ptr<ofxSkeletonLazyData> ofxSkeletonLazyData::createWithFile (const char* skeletonDataFile, spAtlas* atlas, float scale) {
+	return make_shared<ofxSkeletonLazyData>(skeletonDataFile, atlas, scale);
+}
+
+shared_ptr<ofxSkeletonLazyData> ofxSkeletonLazyData::createWithFile (const char* skeletonDataFile, const char* atlasFile, float scale) {
+	return make_shared<ofxSkeletonLazyData>(skeletonDataFile, atlasFile, scale);
+}
+
+ofxSkeletonLazyData::ofxSkeletonLazyData(const char* skeletonDataFile, spAtlas* atlas, float scale) {
+	initialize(skeletonDataFile, atlas, scale);
+}
+
+ofxSkeletonLazyData::ofxSkeletonLazyData(const char* skeletonDataFile, const char* atlasFile, float scale) {
+	spAtlas* atlas = spAtlas_createFromFile(atlasFile, 0);
+	if (!atlas) ofLogError("ofxSkeletonLazyData") << "Error reading atlas file: " << atlasFile;
+	initialize(skeletonDataFile, atlas, scale);
+	ownsAtlas = atlas != 0;
+}
+
+ofxSkeletonLazyData::~ofxSkeletonLazyData() {
+	for (size_t i = 0; i < clips.size(); ++i)
+		if (staged[i]) spAnimation_dispose(staged[i]);
+	if (skeletonData) spSkeletonData_dispose(skeletonData);
+	if (ownsAtlas) spAtlas_dispose(atlas);
+}
+
+void ofxSkeletonLazyData::initialize (const char* skeletonDataFile, spAtlas* atlas, float scale) {
+	skeletonData = 0;
+	this->atlas = atlas;
+	ownsAtlas = false;
+	this->scale = scale;
+	path = skeletonDataFile;
+	skinsBegin = skinsEnd = 0;
+	frame = 0;
+	loadedCount = 0;
+	residentBytes = 0;
+	loads = 0;
+	evictions = 0;
+	loadMillis = 0;
+
+	shared_ptr<ofxSpineFile> file = ofxSpineOpenFile(skeletonDataFile);
+	if (!file) {
+		ofLogError("ofxSkeletonLazyData") << "Error reading skeleton data file: " << skeletonDataFile;
+		return;
+	}
+
+	const char* json = file->getData();
+	size_t length = file->getSize();
+	ofxSkeletonJsonIndex root;
+	if (!root.index(json, length)) return;
+	for (size_t i = 0; i < root.members.size(); ++i) {
+		const ofxSkeletonJsonIndex::Member& member = root.members[i];
+		if (member.name == "animations") continue;
+		if (member.name == "skins") {
+			skinsBegin = member.begin;
+			skinsEnd = member.end;
+			continue;
+		}
+		if (!header.empty()) header += ",";
+		header.append(json + member.begin, member.end - member.begin);
+	}
+
+	// Everything but the animations, parsed once.
+	string base = "{" + header;
+	if (skinsEnd > skinsBegin) {
+		if (!header.empty()) base += ",";
+		base.append(json + skinsBegin, skinsEnd - skinsBegin);
+	}
+	base += "}";
+	spSkeletonJson* skeletonJson = spSkeletonJson_create(atlas);
+	skeletonJson->scale = scale;
+	skeletonData = spSkeletonJson_readSkeletonData(skeletonJson, base.c_str());
+	if (!skeletonData) ofLogError("ofxSkeletonLazyData") << (skeletonJson->error ? skeletonJson->error : "Error reading skeleton data.");
+	spSkeletonJson_dispose(skeletonJson);
+
+	const ofxSkeletonJsonIndex::Member* animations = root.find("animations");
+	ofxSkeletonJsonIndex animationsIndex;
+	if (skeletonData && animations && animationsIndex.index(json, length, animations->valueBegin)) {
+		// Empty animations, filled by load().
+		skeletonData->animationsCount = animationsIndex.members.size();
+		skeletonData->animations = MALLOC(spAnimation*, skeletonData->animationsCount);
+		for (size_t i = 0; i < animationsIndex.members.size(); ++i) {
+			const ofxSkeletonJsonIndex::Member& member = animationsIndex.members[i];
+			Clip clip;
+			clip.animation = spAnimation_create(member.name.c_str(), 0);
+			clip.begin = member.begin;
+			clip.end = member.end;
+			clip.ffd = ofxSkeletonJsonIndex::containsKey(json, member.valueBegin, member.end, "ffd");
+			clip.bytes = 0;
+			skeletonData->animations[i] = clip.animation;
+			clipIndices[clip.animation] = clips.size();
+			clips.push_back(clip);
+		}
+	}
+	lastUsed.reset(new std::atomic<int>[clips.size()]);
+	loaded.reset(new std::atomic<bool>[clips.size()]);
+	staged.reset(new std::atomic<spAnimation*>[clips.size()]);
+	for (size_t i = 0; i < clips.size(); ++i) {
+		lastUsed[i] = 0;
+		loaded[i] = false;
+		staged[i] = 0;
+	}
+}
+
+string ofxSkeletonLazyData::readRange (size_t begin, size_t end) const {
+	// A mapped file is shared with every other load of it, so this copies only the range.
+	if (ofxSpineGetFileSource()) {
+		shared_ptr<ofxSpineFile> file = ofxSpineOpenFile(path);
+		if (file && end <= file->getSize()) return string(file->getData() + begin, end - begin);
+		ofLogError("ofxSkeletonLazyData") << "Error reading " << path;
+		return string();
+	}
+	string text(end - begin, ' ');
+	ifstream file(ofToDataPath(path).c_str(), ios::binary);
+	file.seekg(begin);
+	file.read(&text[0], text.size());
+	if (!file) {
+		ofLogError("ofxSkeletonLazyData") << "Error reading " << path;
+		return string();
+	}
+	return text;
+}
+
+/* Parses the clip into a standalone animation. Called with the mutex held, from any thread. */
+spAnimation* ofxSkeletonLazyData::parse (const Clip& clip) {
+	uint64_t start = ofGetElapsedTimeMicros();
+
+	// The clip with just enough of the skeleton to resolve its bone, slot, event and attachment references.
+	string json = "{" + header;
+	if (clip.ffd && skinsEnd > skinsBegin) json += "," + readRange(skinsBegin, skinsEnd);
+	string range = readRange(clip.begin, clip.end);
+	if (range.empty()) return 0;
+	json += ",\"animations\":{" + range + "}}";
+
+	spSkeletonJson* skeletonJson = spSkeletonJson_create(atlas);
+	skeletonJson->scale = scale;
+	spSkeletonData* parsedData = spSkeletonJson_readSkeletonData(skeletonJson, json.c_str());
+	if (!parsedData || parsedData->animationsCount != 1) {
+		ofLogError("ofxSkeletonLazyData") << "Error reading animation " << clip.animation->name << ": "
+			<< (skeletonJson->error ? skeletonJson->error : "");
+		spSkeletonJson_dispose(skeletonJson);
+		if (parsedData) spSkeletonData_dispose(parsedData);
+		return 0;
+	}
+	spSkeletonJson_dispose(skeletonJson);
+
+	spAnimation* parsed = parsedData->animations[0];
+	ofxSkeletonJsonIndex::remap(parsed, parsedData, skeletonData);
+	parsedData->animationsCount = 0;
+	spSkeletonData_dispose(parsedData);
+
+	loads++;
+	loadMillis += (ofGetElapsedTimeMicros() - start) / 1000.0;
+	return parsed;
+}
+
+bool ofxSkeletonLazyData::load (spAnimation* animation) {
+	auto found = clipIndices.find(animation);
+	if (found == clipIndices.end()) return false;
+	int index = found->second;
+	if (loaded[index].load(std::memory_order_relaxed)) return true;
+
+	// Take what prefetch() parsed on another thread, or parse it now.
+	spAnimation* parsed = staged[index].exchange(0, std::memory_order_acquire);
+	if (!parsed) {
+		std::lock_guard<std::mutex> lock(mutex);
+		parsed = staged[index].exchange(0, std::memory_order_acquire);
+		if (!parsed) parsed = parse(clips[index]);
+		if (!parsed) return false;
+	}
+
+	// Only this thread reads the animation, so it can be filled in place.
+	Clip& clip = clips[index];
+	animation->duration = parsed->duration;
+	FREE(animation->timelines); // The empty array spAnimation_create allocated, or 0 once evicted.
+	animation->timelines = parsed->timelines;
+	animation->timelinesCount = parsed->timelinesCount;
+	parsed->timelines = 0;
+	parsed->timelinesCount = 0;
+	spAnimation_dispose(parsed);
+
+	clip.bytes = getAnimationBytes(animation);
+	lastUsed[index] = frame;
+	loadedCount++;
+	residentBytes += clip.bytes;
+	loaded[index].store(true, std::memory_order_release);
+	return true;
+}
+
+bool ofxSkeletonLazyData::load (const char* animationName) {
+	if (!skeletonData) return false;
+	spAnimation* animation = spSkeletonData_findAnimation(skeletonData, animationName);
+	return animation && load(animation);
+}
+
+bool ofxSkeletonLazyData::prefetch (spAnimation* animation) {
+	auto found = clipIndices.find(animation);
+	if (found == clipIndices.end()) return false;
+	int index = found->second;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (loaded[index].load(std::memory_order_acquire) || staged[index].load(std::memory_order_relaxed)) return true;
+	spAnimation* parsed = parse(clips[index]);
+	if (!parsed) return false;
+	staged[index].store(parsed, std::memory_order_release);
+	return true;
+}
+
+bool ofxSkeletonLazyData::prefetch (const char* animationName) {
+	if (!skeletonData) return false;
+	spAnimation* animation = spSkeletonData_findAnimation(skeletonData, animationName);
+	return animation && prefetch(animation);
+}
+
+bool ofxSkeletonLazyData::isLoaded (const spAnimation* animation) const {
+	auto found = clipIndices.find(animation);
+	return found != clipIndices.end() && loaded[found->second].load(std::memory_order_acquire);
+}
+
+int ofxSkeletonLazyData::getLoads () const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return loads;
+}
+
+double ofxSkeletonLazyData::getLoadMillis () const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return loadMillis;
+}
+
+void ofxSkeletonLazyData::touch (const spAnimation* animation) {
+	auto found = clipIndices.find(animation);
+	if (found != clipIndices.end()) lastUsed[found->second].store(frame, std::memory_order_relaxed);
+}
+
+bool ofxSkeletonLazyData::evict (spAnimation* animation) {
+	auto found = clipIndices.find(animation);
+	if (found == clipIndices.end()) return false;
+
+	Clip& clip = clips[found->second];
+	if (!loaded[found->second].load(std::memory_order_relaxed)) return false;
+	for (int i = 0; i < animation->timelinesCount; ++i)
+		spTimeline_dispose(animation->timelines[i]);
+	FREE(animation->timelines);
+	animation->timelines = 0;
+	animation->timelinesCount = 0;
+	// The duration is kept, track entries queued with it stay valid.
+
+	loaded[found->second].store(false, std::memory_order_release);
+	loadedCount--;
+	residentBytes -= clip.bytes;
+	clip.bytes = 0;
+	evictions++;
+	return true;
+}
+
+int ofxSkeletonLazyData::evictUnused (int idleFrames) {
+	int count = 0;
+	for (size_t i = 0; i < clips.size(); ++i)
+		if (loaded[i].load(std::memory_order_relaxed) && frame - lastUsed[i].load(std::memory_order_relaxed) > idleFrames && evict(clips[i].animation))
+			count++;
+	return count;
+}
+
+/* Floats per key. */
+static int frameSize (spTimelineType type) {
+	switch (type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY:
+		return 2;
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE:
+	case SP_TIMELINE_IKCONSTRAINT:
+		return 3;
+	case SP_TIMELINE_COLOR:
+		return 5;
+	default:
+		return 1;
+	}
+}
+
+size_t ofxSkeletonLazyData::getAnimationBytes (const spAnimation* animation) {
+	size_t bytes = sizeof(spAnimation) + animation->timelinesCount * sizeof(spTimeline*);
+	for (int i = 0; i < animation->timelinesCount; ++i)
+		bytes += getTimelineBytes(animation->timelines[i]);
+	return bytes;
+}
+
+size_t ofxSkeletonLazyData::getTimelineBytes (const spTimeline* timeline) {
+	if (ofxSkeletonCompression::isCompressed(timeline)) return ofxSkeletonCompression::getCompressedBytes(timeline);
+	size_t bytes = 0;
+	int keys = 0;
+	switch (timeline->type) {
+	case SP_TIMELINE_ROTATE:
+	case SP_TIMELINE_TRANSLATE:
+	case SP_TIMELINE_SCALE: {
+		const spBaseTimeline* base = (const spBaseTimeline*)timeline;
+		keys = base->framesCount / frameSize(timeline->type);
+		bytes += sizeof(spBaseTimeline) + base->framesCount * sizeof(float);
+		break;
+	}
+	case SP_TIMELINE_COLOR: {
+		const spColorTimeline* color = (const spColorTimeline*)timeline;
+		keys = color->framesCount / frameSize(timeline->type);
+		bytes += sizeof(spColorTimeline) + color->framesCount * sizeof(float);
+		break;
+	}
+	case SP_TIMELINE_IKCONSTRAINT: {
+		const spIkConstraintTimeline* ik = (const spIkConstraintTimeline*)timeline;
+		keys = ik->framesCount / frameSize(timeline->type);
+		bytes += sizeof(spIkConstraintTimeline) + ik->framesCount * sizeof(float);
+		break;
+	}
+	case SP_TIMELINE_FFD: {
+		const spFFDTimeline* ffd = (const spFFDTimeline*)timeline;
+		keys = ffd->framesCount;
+		bytes += sizeof(spFFDTimeline) + keys * (sizeof(float) + sizeof(float*) + ffd->frameVerticesCount * sizeof(float));
+		break;
+	}
+	case SP_TIMELINE_ATTACHMENT: {
+		const spAttachmentTimeline* attachment = (const spAttachmentTimeline*)timeline;
+		bytes += sizeof(spAttachmentTimeline) + attachment->framesCount * (sizeof(float) + sizeof(char*));
+		for (int i = 0; i < attachment->framesCount; ++i)
+			if (attachment->attachmentNames[i]) bytes += strlen(attachment->attachmentNames[i]) + 1;
+		break;
+	}
+	case SP_TIMELINE_EVENT: {
+		const spEventTimeline* events = (const spEventTimeline*)timeline;
+		bytes += sizeof(spEventTimeline) + events->framesCount * (sizeof(float) + sizeof(spEvent*) + sizeof(spEvent));
+		break;
+	}
+	case SP_TIMELINE_DRAWORDER: {
+		const spDrawOrderTimeline* drawOrder = (const spDrawOrderTimeline*)timeline;
+		bytes += sizeof(spDrawOrderTimeline) + drawOrder->framesCount * (sizeof(float) + sizeof(int*));
+		for (int i = 0; i < drawOrder->framesCount; ++i)
+			if (drawOrder->drawOrders[i]) bytes += drawOrder->slotsCount * sizeof(int);
+		break;
+	}
+	case SP_TIMELINE_FLIPX:
+	case SP_TIMELINE_FLIPY: {
+		const spFlipTimeline* flip = (const spFlipTimeline*)timeline;
+		bytes += sizeof(spFlipTimeline) + flip->framesCount * sizeof(float);
+		break;
+	}
+	}
+	// Curve timelines keep 19 floats per segment, see spCurveTimeline_create.
+	if (keys > 1) bytes += (keys - 1) * 19 * sizeof(float);
+	return bytes;
+}
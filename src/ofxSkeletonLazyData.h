@@ -0,0 +1,103 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include <atomic>
+#include <mutex>
+
+/** Loads a skeleton file without its animation timelines. Every animation exists from the start (same name and pointer, so
+  * findAnimation, mixes and queued commands work as usual) but stays empty until first used: ofxSkeletonAnimation loads it on
+  * setAnimation / addAnimation when given this data with setLazyData(), or call prefetch() up front. Only the bones, slots,
+  * events and constraints stay in memory as JSON; animations and skins are read back from the file when an animation is
+  * loaded.
+  *
+  * evict() and evictUnused() free timelines again. An evicted animation must not be playing on any AnimationState; with
+  * evictUnused() after beginFrame(), animations touched by an update() within the last idle frames are kept.
+  *
+  * prefetch() and isLoaded() may be called from any thread; prefetch() only parses, and the timelines are handed to the
+  * animation by the next load() for it. load() and the other methods must be called from the thread updating the instances,
+  * the only one reading the animations. */
+class ofxSkeletonLazyData
+{
+public:
+	static shared_ptr<ofxSkeletonLazyData> createWithFile (const char* skeletonDataFile, spAtlas* atlas, float scale = 1);
+	static shared_ptr<ofxSkeletonLazyData> createWithFile (const char* skeletonDataFile, const char* atlasFile, float scale = 1);
+
+	ofxSkeletonLazyData(const char* skeletonDataFile, spAtlas* atlas, float scale = 1);
+	ofxSkeletonLazyData(const char* skeletonDataFile, const char* atlasFile, float scale = 1);
+	~ofxSkeletonLazyData();
+
+	/* Returns 0 if the file could not be loaded. */
+	spSkeletonData* getSkeletonData () const { return skeletonData; }
+
+	/* Makes the animation's timelines resident, parsing them unless prefetch() already did. Returns false if the animation does
+	 * not belong to this data or could not be parsed. Update thread only. */
+	bool load (spAnimation* animation);
+	bool load (const char* animationName);
+	/* Parses the animation's timelines ahead of load(), from any thread. Returns false if the animation was not found or could
+	 * not be parsed. */
+	bool prefetch (spAnimation* animation);
+	bool prefetch (const char* animationName);
+	bool isLoaded (const spAnimation* animation) const;
+
+	/* Marks the animation as used this frame. Called by ofxSkeletonAnimation::update() for every track. */
+	void touch (const spAnimation* animation);
+	/* Advances the frame counter used by evictUnused(). */
+	void beginFrame () { frame++; }
+
+	/* Returns false if the animation was not loaded. */
+	bool evict (spAnimation* animation);
+	/* Evicts animations not touched during the last idleFrames frames. Returns the number evicted. */
+	int evictUnused (int idleFrames);
+
+	int getAnimationsCount () const { return clips.size(); }
+	int getLoadedCount () const { return loadedCount; }
+	/* Estimated bytes held by the timelines of the loaded animations. */
+	size_t getResidentBytes () const { return residentBytes; }
+	/* Bytes of JSON kept in memory for loading animations. */
+	size_t getSourceBytes () const { return header.size(); }
+	/* Animations parsed. */
+	int getLoads () const;
+	int getEvictions () const { return evictions; }
+	double getLoadMillis () const;
+
+	/* Estimated bytes of the animation's timelines, keys and curves. */
+	static size_t getAnimationBytes (const spAnimation* animation);
+	static size_t getTimelineBytes (const spTimeline* timeline);
+
+private:
+	struct Clip
+	{
+		spAnimation* animation;
+		size_t begin, end; // "name": {...} in the file.
+		bool ffd; // Needs the skins to resolve its attachments.
+		size_t bytes;
+	};
+
+	void initialize (const char* skeletonDataFile, spAtlas* atlas, float scale);
+	string readRange (size_t begin, size_t end) const;
+	spAnimation* parse (const Clip& clip);
+
+	spSkeletonData* skeletonData;
+	spAtlas* atlas;
+	bool ownsAtlas;
+	float scale;
+	string path;
+	string header; // Members besides animations and skins, comma separated.
+	size_t skinsBegin, skinsEnd;
+
+	vector<Clip> clips;
+	unordered_map<const spAnimation*, int> clipIndices;
+	unique_ptr<std::atomic<int>[]> lastUsed;
+	unique_ptr<std::atomic<bool>[]> loaded; // Timelines installed in the animation.
+	unique_ptr<std::atomic<spAnimation*>[]> staged; // Parsed by prefetch(), waiting for load().
+	int frame;
+
+	mutable std::mutex mutex; // Guards parsing, loads and loadMillis.
+	int loadedCount;
+	size_t residentBytes;
+	int loads;
+	int evictions;
+	double loadMillis;
+};
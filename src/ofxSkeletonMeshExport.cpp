@@ -0,0 +1,109 @@
+#include "ofxSkeletonMeshExport.h"
+
+shared_ptr<ofxSkeletonMeshExport> ofxSkeletonMeshExport::create (shared_ptr<ofxSkeletonRenderer> renderer) {
+	return make_shared<ofxSkeletonMeshExport>(renderer);
+}
+
+ofxSkeletonMeshExport::ofxSkeletonMeshExport(shared_ptr<ofxSkeletonRenderer> renderer)
+	: renderer(renderer) {
+	memset(&stats, 0, sizeof(stats));
+}
+
+bool ofxSkeletonMeshExport::update (ofVboMesh& mesh) {
+	list.clear();
+	renderer->collectCurrent(list);
+	const vector<ofxSkeletonDrawList::Item>& items = list.items;
+	int verticesCount = list.vertices.size() / 2;
+
+	bool changed = items.size() != keys.size() || (int)mesh.getNumVertices() != verticesCount
+		|| (int)mesh.getNumIndices() != stats.indices;
+	for (size_t i = 0; i < items.size() && !changed; ++i) {
+		const ofxSkeletonDrawList::Item& item = items[i];
+		const Key& key = keys[i];
+		changed = item.texture != key.texture || item.blendSrc != key.blendSrc || item.blendDst != key.blendDst
+			|| item.uvs != key.uvs || item.triangles != key.triangles || item.verticesCount != key.verticesCount;
+	}
+	if (changed) rebuild(mesh);
+	stats.vertices = verticesCount;
+	if (!verticesCount) {
+		// getVerticesPointer() and getColorsPointer() take &v[0], which an empty mesh does not have.
+		stats.updatedBytes = changed ? stats.staticBytes : 0;
+		return changed;
+	}
+
+	// Only the non-const getters below mark the positions and colors as changed; texture coordinates and indices stay uploaded.
+	ofVec3f* positions = mesh.getVerticesPointer();
+	ofFloatColor* colors = mesh.getColorsPointer();
+	for (size_t i = 0; i < items.size(); ++i) {
+		const ofxSkeletonDrawList::Item& item = items[i];
+		ofFloatColor color(item.color);
+		const float* vertices = &list.vertices[item.verticesOffset];
+		for (int ii = 0; ii < item.verticesCount; ii += 2) {
+			*positions = ofVec3f(vertices[ii], vertices[ii + 1], 0);
+			*colors = color;
+			positions++;
+			colors++;
+		}
+	}
+	stats.updatedBytes = verticesCount * (sizeof(ofVec3f) + sizeof(ofFloatColor)) + (changed ? stats.staticBytes : 0);
+	return changed;
+}
+
+void ofxSkeletonMeshExport::rebuild (ofVboMesh& mesh) {
+	const vector<ofxSkeletonDrawList::Item>& items = list.items;
+	int verticesCount = list.vertices.size() / 2;
+
+	mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+	mesh.setUsage(GL_DYNAMIC_DRAW);
+	mesh.getVertices().resize(verticesCount);
+	mesh.getColors().resize(verticesCount);
+	vector<ofVec2f>& texCoords = mesh.getTexCoords();
+	vector<ofIndexType>& indices = mesh.getIndices();
+	texCoords.resize(verticesCount);
+	indices.clear();
+
+	keys.resize(items.size());
+	submeshes.clear();
+	int vertex = 0;
+	for (size_t i = 0; i < items.size(); ++i) {
+		const ofxSkeletonDrawList::Item& item = items[i];
+		Key& key = keys[i];
+		key.texture = item.texture;
+		key.blendSrc = item.blendSrc;
+		key.blendDst = item.blendDst;
+		key.uvs = item.uvs;
+		key.triangles = item.triangles;
+		key.verticesCount = item.verticesCount;
+
+		if (i == 0 || !ofxSkeletonDrawList::canBatch(items[i - 1], item)) {
+			Submesh submesh = { item.texture, item.blendSrc, item.blendDst, (int)indices.size(), 0 };
+			submeshes.push_back(submesh);
+		}
+		// Rectangle textures are addressed in pixels.
+		bool normalized = item.texture->texData.textureTarget == GL_TEXTURE_2D;
+		float width = normalized ? 1 : item.texture->texData.width;
+		float height = normalized ? 1 : item.texture->texData.height;
+		for (int ii = 0; ii < item.verticesCount; ii += 2)
+			texCoords[vertex + ii / 2] = ofVec2f(item.uvs[ii] * width, item.uvs[ii + 1] * height);
+		for (int ii = 0; ii < item.trianglesCount; ++ii)
+			indices.push_back(vertex + item.triangles[ii]);
+		submeshes.back().indexCount = indices.size() - submeshes.back().indexOffset;
+		vertex += item.verticesCount / 2;
+	}
+
+	stats.indices = indices.size();
+	stats.rebuilds++;
+	stats.staticBytes = verticesCount * sizeof(ofVec2f) + indices.size() * sizeof(ofIndexType);
+}
+
+void ofxSkeletonMeshExport::draw (ofVboMesh& mesh) const {
+	if (submeshes.empty()) return;
+	const ofVbo& vbo = mesh.getVbo();
+	for (size_t i = 0; i < submeshes.size(); ++i) {
+		const Submesh& submesh = submeshes[i];
+		glBlendFunc(submesh.blendSrc, submesh.blendDst);
+		submesh.texture->bind();
+		vbo.drawElements(GL_TRIANGLES, submesh.indexCount, submesh.indexOffset);
+		submesh.texture->unbind();
+	}
+}
@@ -0,0 +1,64 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+#include "ofxSkeletonRenderer.h"
+#include "ofxSkeletonDrawList.h"
+
+/** Writes what a renderer draws into a caller-owned ofVboMesh, for shaders and FBO passes. The mesh is filled in place: texture
+  * coordinates, indices and submeshes are only rebuilt when the attachments, their textures or the draw order change; every
+  * other update() writes just the positions and colors, so only those are uploaded again. The mesh holds triangles in draw
+  * order, with the instance transform applied, one submesh per run of attachments sharing a texture and blend function. */
+class ofxSkeletonMeshExport
+{
+public:
+
+	struct Submesh
+	{
+		ofTexture* texture;
+		GLuint blendSrc, blendDst;
+		int indexOffset;
+		int indexCount;
+	};
+
+	struct Stats
+	{
+		int vertices;
+		int indices;
+		int rebuilds; // Since creation.
+		size_t updatedBytes; // Written by the last update().
+		size_t staticBytes; // Texture coordinates and indices, written by the last rebuild.
+	};
+
+	static shared_ptr<ofxSkeletonMeshExport> create (shared_ptr<ofxSkeletonRenderer> renderer);
+
+	ofxSkeletonMeshExport(shared_ptr<ofxSkeletonRenderer> renderer);
+
+	/* Writes the renderer's current pose into the mesh, without drawing debug geometry or acquiring a snapshot (see
+	 * ofxSkeletonRenderer::collectCurrent). Use one export per mesh. Returns true if texture coordinates and indices were
+	 * rebuilt. */
+	bool update (ofVboMesh& mesh);
+	/* Draws the mesh one submesh at a time with its texture and blend function. */
+	void draw (ofVboMesh& mesh) const;
+
+	const vector<Submesh>& getSubmeshes () const { return submeshes; }
+	const Stats& getStats () const { return stats; }
+
+private:
+	struct Key
+	{
+		ofTexture* texture;
+		GLuint blendSrc, blendDst;
+		const float* uvs;
+		const int* triangles;
+		int verticesCount;
+	};
+
+	void rebuild (ofVboMesh& mesh);
+
+	shared_ptr<ofxSkeletonRenderer> renderer;
+	ofxSkeletonDrawList list;
+	vector<Key> keys;
+	vector<Submesh> submeshes;
+	Stats stats;
+};
@@ -0,0 +1,193 @@
+#include "ofxSkeletonParallelJson.h"
+#include "ofxSkeletonJsonIndex.h"
+#include "ofxSpineFileSource.h"
+
+#include <spine/extension.h>
+#include <atomic>
+#include <set>
+#include <thread>
+
+namespace {
+
+struct Task
+{
+	string json;
+	int skinsCount; // Skins this task contributes, 0 for animation tasks.
+	int animationsCount;
+	spSkeletonData* data;
+
+	Task() : skinsCount(0), animationsCount(0), data(0) {}
+};
+
+}
+
+spSkeletonData* ofxSkeletonParallelJson::readSkeletonDataFile (const char* path, spAtlas* atlas, float scale, int threads,
+	Stats* stats) {
+	// Only ranges of the file are copied, so it is read in place.
+	shared_ptr<ofxSpineFile> file = ofxSpineOpenFile(path);
+	if (!file) {
+		ofLogError("ofxSkeletonParallelJson") << "Error reading skeleton data file: " << path;
+		return 0;
+	}
+	return readSkeletonData(file->getData(), file->getSize(), atlas, scale, threads, stats);
+}
+
+/* Parses the task again, alone, for its message: spine-c keeps the JSON reader's error in a static, which another task may
+ * have overwritten. */
+static void logError (const Task& task, spAtlas* atlas, float scale) {
+	spSkeletonJson* skeletonJson = spSkeletonJson_create(atlas);
+	skeletonJson->scale = scale;
+	spSkeletonData* data = spSkeletonJson_readSkeletonData(skeletonJson, task.json.c_str());
+	if (data) spSkeletonData_dispose(data);
+	ofLogError("ofxSkeletonParallelJson") << (!data && skeletonJson->error ? skeletonJson->error : "Error reading skeleton data.");
+	spSkeletonJson_dispose(skeletonJson);
+}
+
+spSkeletonData* ofxSkeletonParallelJson::readSkeletonData (const char* json, size_t length, spAtlas* atlas, float scale,
+	int threads, Stats* stats) {
+	uint64_t start = ofGetElapsedTimeMicros();
+	if (threads <= 0) threads = max(1, (int)std::thread::hardware_concurrency());
+
+	ofxSkeletonJsonIndex root;
+	if (!root.index(json, length)) {
+		ofLogError("ofxSkeletonParallelJson") << "Error indexing skeleton data.";
+		return 0;
+	}
+	string header;
+	for (size_t i = 0; i < root.members.size(); ++i) {
+		const ofxSkeletonJsonIndex::Member& member = root.members[i];
+		if (member.name == "skins" || member.name == "animations") continue;
+		if (!header.empty()) header += ",";
+		header.append(json + member.begin, member.end - member.begin);
+	}
+	string separator = header.empty() ? "" : ",";
+
+	ofxSkeletonJsonIndex skins, animations;
+	const ofxSkeletonJsonIndex::Member* skinsMember = root.find("skins");
+	const ofxSkeletonJsonIndex::Member* animationsMember = root.find("animations");
+	if ((skinsMember && !skins.index(json, length, skinsMember->valueBegin))
+		|| (animationsMember && !animations.index(json, length, animationsMember->valueBegin))) {
+		ofLogError("ofxSkeletonParallelJson") << "Error indexing skins or animations.";
+		return 0;
+	}
+
+	// Task 0 is the skeleton without skins and animations, the others add to it. Animations are parsed in runs of about equal
+	// size to spread the cost of parsing the header again; a run with FFD timelines also needs the skins they deform.
+	vector<Task> tasks(1 + skins.members.size());
+	tasks[0].json = "{" + header + "}";
+	for (size_t i = 0; i < skins.members.size(); ++i) {
+		const ofxSkeletonJsonIndex::Member& skin = skins.members[i];
+		tasks[i + 1].json = "{" + header + separator + "\"skins\":{" + string(json + skin.begin, skin.end - skin.begin) + "}}";
+		tasks[i + 1].skinsCount = 1;
+	}
+	size_t animationsBytes = animationsMember ? animationsMember->end - animationsMember->valueBegin : 0;
+	size_t runBytes = max(animationsBytes / (threads * 4), (size_t)1);
+	for (size_t i = 0; i < animations.members.size();) {
+		set<string> ffdSkins;
+		string run;
+		size_t bytes = 0;
+		int count = 0;
+		for (; i < animations.members.size() && (count == 0 || bytes < runBytes); ++i, ++count) {
+			const ofxSkeletonJsonIndex::Member& animation = animations.members[i];
+			if (!run.empty()) run += ",";
+			run.append(json + animation.begin, animation.end - animation.begin);
+			bytes += animation.end - animation.begin;
+
+			ofxSkeletonJsonIndex members, ffd;
+			if (!ofxSkeletonJsonIndex::containsKey(json, animation.valueBegin, animation.end, "ffd")) continue;
+			if (!members.index(json, length, animation.valueBegin)) {
+				ofLogError("ofxSkeletonParallelJson") << "Error indexing animation: " << animation.name;
+				return 0;
+			}
+			const ofxSkeletonJsonIndex::Member* ffdMember = members.find("ffd");
+			if (!ffdMember || !ffd.index(json, length, ffdMember->valueBegin)) continue;
+			for (size_t ii = 0; ii < ffd.members.size(); ++ii) {
+				if (!ffdSkins.insert(ffd.members[ii].name).second) continue;
+				const ofxSkeletonJsonIndex::Member* skin = skins.find(ffd.members[ii].name);
+				if (skin) bytes += skin->end - skin->begin;
+			}
+		}
+		Task task;
+		task.json = "{" + header + separator;
+		if (!ffdSkins.empty()) {
+			task.json += "\"skins\":{";
+			bool first = true;
+			for (size_t ii = 0; ii < skins.members.size(); ++ii) {
+				const ofxSkeletonJsonIndex::Member& skin = skins.members[ii];
+				if (!ffdSkins.count(skin.name)) continue;
+				if (!first) task.json += ",";
+				task.json.append(json + skin.begin, skin.end - skin.begin);
+				first = false;
+			}
+			task.json += "},";
+		}
+		task.json += "\"animations\":{" + run + "}}";
+		task.animationsCount = count;
+		tasks.push_back(task);
+	}
+	uint64_t parseStart = ofGetElapsedTimeMicros();
+
+	std::atomic<int> nextTask(0);
+	auto work = [&]() {
+		for (int i = nextTask++; i < (int)tasks.size(); i = nextTask++) {
+			Task& task = tasks[i];
+			spSkeletonJson* skeletonJson = spSkeletonJson_create(atlas);
+			skeletonJson->scale = scale;
+			task.data = spSkeletonJson_readSkeletonData(skeletonJson, task.json.c_str());
+			spSkeletonJson_dispose(skeletonJson);
+		}
+	};
+	int workers = min(threads, (int)tasks.size());
+	vector<std::thread> pool;
+	for (int i = 1; i < workers; ++i) pool.push_back(std::thread(work));
+	work();
+	for (size_t i = 0; i < pool.size(); ++i) pool[i].join();
+	uint64_t mergeStart = ofGetElapsedTimeMicros();
+
+	spSkeletonData* skeletonData = tasks[0].data;
+	bool failed = false;
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		Task& task = tasks[i];
+		if (task.data && (!task.skinsCount || task.data->skinsCount == 1) && task.data->animationsCount == task.animationsCount)
+			continue;
+		if (!failed) logError(task, atlas, scale);
+		failed = true;
+	}
+	if (failed) {
+		for (size_t i = 0; i < tasks.size(); ++i)
+			if (tasks[i].data) spSkeletonData_dispose(tasks[i].data);
+		return 0;
+	}
+
+	skeletonData->skinsCount = skins.members.size();
+	skeletonData->skins = MALLOC(spSkin*, skeletonData->skinsCount);
+	skeletonData->animationsCount = animations.members.size();
+	skeletonData->animations = MALLOC(spAnimation*, skeletonData->animationsCount);
+	int skinsCount = 0, animationsCount = 0;
+	for (size_t i = 1; i < tasks.size(); ++i) {
+		spSkeletonData* data = tasks[i].data;
+		if (tasks[i].skinsCount) {
+			spSkin* skin = data->skins[0];
+			skeletonData->skins[skinsCount++] = skin;
+			if (data->defaultSkin == skin) skeletonData->defaultSkin = skin;
+			data->skinsCount = 0;
+			data->defaultSkin = 0;
+		} else {
+			for (int ii = 0; ii < data->animationsCount; ++ii) {
+				ofxSkeletonJsonIndex::remap(data->animations[ii], data, skeletonData);
+				skeletonData->animations[animationsCount++] = data->animations[ii];
+			}
+			data->animationsCount = 0;
+		}
+		spSkeletonData_dispose(data);
+	}
+
+	if (stats) {
+		stats->threads = workers;
+		stats->tasks = tasks.size();
+		stats->indexMillis = (parseStart - start) / 1000.0;
+		stats->parseMillis = (mergeStart - parseStart) / 1000.0;
+		stats->mergeMillis = (ofGetElapsedTimeMicros() - mergeStart) / 1000.0;
+	}
+	return skeletonData;
+}
@@ -0,0 +1,34 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+
+/** Reads a skeleton file on several threads. The document is indexed once (ofxSkeletonJsonIndex), then every skin and every
+  * run of animations is parsed by spSkeletonJson as a document of its own, together with the bones, slots, IK constraints
+  * and events it refers to. The parts are moved into one SkeletonData in file order, so the result is the same as
+  * spSkeletonJson_readSkeletonData gives; only the time to get it differs. The atlas is shared by the threads and only read.
+  *
+  * This relies on spine-c's JSON reader being reentrant apart from its static error pointer, which every Json_create resets
+  * and a parse error sets (a race a thread sanitizer reports). Nothing parsed reads it; a failed part is parsed again alone
+  * to report its error. */
+class ofxSkeletonParallelJson
+{
+public:
+
+	struct Stats
+	{
+		int threads;
+		int tasks;
+		double indexMillis;
+		double parseMillis; // Wall time of the parallel part.
+		double mergeMillis;
+	};
+
+	/* threads 0 uses one per hardware thread. Returns 0 and logs if the file could not be read or parsed. The caller
+	 * disposes the SkeletonData. */
+	static spSkeletonData* readSkeletonDataFile (const char* path, spAtlas* atlas, float scale = 1, int threads = 0,
+		Stats* stats = 0);
+	static spSkeletonData* readSkeletonData (const char* json, size_t length, spAtlas* atlas, float scale = 1,
+		int threads = 0, Stats* stats = 0);
+};
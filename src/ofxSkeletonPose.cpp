@@ -0,0 +1,277 @@
+#include "ofxSkeletonPose.h"
+
+#include <spine/extension.h>
+
+ofxSkeletonPose::ofxSkeletonPose()
+	: data(0), x(0), y(0), r(1), g(1), b(1), a(1), flipX(false), flipY(false), time(0) {
+}
+
+void ofxSkeletonPose::capture (const spSkeleton* skeleton) {
+	// Slot to bone indices are fixed by the SkeletonData, only look them up for a new one.
+	bool sameData = data == skeleton->data && (int)slots.size() == skeleton->slotsCount;
+	data = skeleton->data;
+	x = skeleton->x;
+	y = skeleton->y;
+	r = skeleton->r;
+	g = skeleton->g;
+	b = skeleton->b;
+	a = skeleton->a;
+	flipX = skeleton->flipX != 0;
+	flipY = skeleton->flipY != 0;
+
+	bones.resize(skeleton->bonesCount);
+	for (int i = 0; i < skeleton->bonesCount; ++i) {
+		const spBone* bone = skeleton->bones[i];
+		Bone& pose = bones[i];
+		pose.x = bone->x;
+		pose.y = bone->y;
+		pose.rotation = bone->rotation;
+		pose.scaleX = bone->scaleX;
+		pose.scaleY = bone->scaleY;
+		pose.a = bone->a;
+		pose.b = bone->b;
+		pose.c = bone->c;
+		pose.d = bone->d;
+		pose.worldX = bone->worldX;
+		pose.worldY = bone->worldY;
+	}
+
+	slots.resize(skeleton->slotsCount);
+	attachmentVertices.clear();
+	for (int i = 0; i < skeleton->slotsCount; ++i) {
+		const spSlot* slot = skeleton->slots[i];
+		Slot& pose = slots[i];
+		pose.r = slot->r;
+		pose.g = slot->g;
+		pose.b = slot->b;
+		pose.a = slot->a;
+		pose.attachment = slot->attachment;
+		if (!sameData) {
+			pose.boneIndex = 0;
+			for (int ii = 0; ii < skeleton->bonesCount; ++ii) {
+				if (skeleton->bones[ii] == slot->bone) {
+					pose.boneIndex = ii;
+					break;
+				}
+			}
+		}
+		pose.verticesOffset = attachmentVertices.size();
+		pose.verticesCount = slot->attachmentVerticesCount;
+		if (slot->attachmentVerticesCount)
+			attachmentVertices.insert(attachmentVertices.end(), slot->attachmentVertices, slot->attachmentVertices + slot->attachmentVerticesCount);
+	}
+
+	// The draw order is usually close to the setup order, so start looking at the same index.
+	int n = skeleton->slotsCount;
+	drawOrder.resize(n);
+	for (int i = 0; i < n; ++i) {
+		const spSlot* slot = skeleton->drawOrder[i];
+		for (int ii = 0; ii < n; ++ii) {
+			int index = (i + ii) % n;
+			if (skeleton->slots[index] == slot) {
+				drawOrder[i] = index;
+				break;
+			}
+		}
+	}
+}
+
+void ofxSkeletonPose::apply (spSkeleton* skeleton) const {
+	if ((int)bones.size() != skeleton->bonesCount || (int)slots.size() != skeleton->slotsCount) return;
+	applyBones(skeleton);
+
+	for (int i = 0; i < skeleton->slotsCount; ++i) {
+		spSlot* slot = skeleton->slots[i];
+		const Slot& pose = slots[i];
+		slot->r = pose.r;
+		slot->g = pose.g;
+		slot->b = pose.b;
+		slot->a = pose.a;
+		if (slot->attachment != pose.attachment) spSlot_setAttachment(slot, pose.attachment);
+		if (pose.verticesCount > slot->attachmentVerticesCapacity) {
+			FREE(slot->attachmentVertices);
+			slot->attachmentVertices = MALLOC(float, pose.verticesCount);
+			slot->attachmentVerticesCapacity = pose.verticesCount;
+		}
+		if (pose.verticesCount)
+			memcpy(slot->attachmentVertices, &attachmentVertices[pose.verticesOffset], pose.verticesCount * sizeof(float));
+		slot->attachmentVerticesCount = pose.verticesCount;
+	}
+
+	for (int i = 0; i < skeleton->slotsCount; ++i)
+		skeleton->drawOrder[i] = skeleton->slots[drawOrder[i]];
+}
+
+void ofxSkeletonPose::applyBones (spSkeleton* skeleton) const {
+	if ((int)bones.size() != skeleton->bonesCount) return;
+
+	for (int i = 0; i < skeleton->bonesCount; ++i) {
+		spBone* bone = skeleton->bones[i];
+		const Bone& pose = bones[i];
+		bone->x = pose.x;
+		bone->y = pose.y;
+		bone->rotation = pose.rotation;
+		bone->scaleX = pose.scaleX;
+		bone->scaleY = pose.scaleY;
+		CONST_CAST(float, bone->a) = pose.a;
+		CONST_CAST(float, bone->b) = pose.b;
+		CONST_CAST(float, bone->c) = pose.c;
+		CONST_CAST(float, bone->d) = pose.d;
+		CONST_CAST(float, bone->worldX) = pose.worldX;
+		CONST_CAST(float, bone->worldY) = pose.worldY;
+	}
+}
+
+void ofxSkeletonPose::interpolate (const ofxSkeletonPose& from, const ofxSkeletonPose& to, float alpha) {
+	if (from.data != to.data || from.bones.size() != to.bones.size() || from.slots.size() != to.slots.size()) {
+		*this = to;
+		return;
+	}
+	const ofxSkeletonPose& nearest = alpha < 0.5f ? from : to;
+	data = to.data;
+	x = ofLerp(from.x, to.x, alpha);
+	y = ofLerp(from.y, to.y, alpha);
+	r = ofLerp(from.r, to.r, alpha);
+	g = ofLerp(from.g, to.g, alpha);
+	b = ofLerp(from.b, to.b, alpha);
+	a = ofLerp(from.a, to.a, alpha);
+	flipX = nearest.flipX;
+	flipY = nearest.flipY;
+	time = from.time + (to.time - from.time) * alpha;
+
+	bones.resize(to.bones.size());
+	for (size_t i = 0; i < bones.size(); ++i) {
+		const Bone& p = from.bones[i];
+		const Bone& n = to.bones[i];
+		Bone& bone = bones[i];
+		bone.x = p.x + (n.x - p.x) * alpha;
+		bone.y = p.y + (n.y - p.y) * alpha;
+		bone.rotation = p.rotation + ofWrapDegrees(n.rotation - p.rotation) * alpha;
+		bone.scaleX = p.scaleX + (n.scaleX - p.scaleX) * alpha;
+		bone.scaleY = p.scaleY + (n.scaleY - p.scaleY) * alpha;
+		bone.a = p.a + (n.a - p.a) * alpha;
+		bone.b = p.b + (n.b - p.b) * alpha;
+		bone.c = p.c + (n.c - p.c) * alpha;
+		bone.d = p.d + (n.d - p.d) * alpha;
+		bone.worldX = p.worldX + (n.worldX - p.worldX) * alpha;
+		bone.worldY = p.worldY + (n.worldY - p.worldY) * alpha;
+	}
+
+	slots.resize(to.slots.size());
+	attachmentVertices.clear();
+	for (size_t i = 0; i < slots.size(); ++i) {
+		const Slot& p = from.slots[i];
+		const Slot& n = to.slots[i];
+		Slot& slot = slots[i];
+		slot.r = p.r + (n.r - p.r) * alpha;
+		slot.g = p.g + (n.g - p.g) * alpha;
+		slot.b = p.b + (n.b - p.b) * alpha;
+		slot.a = p.a + (n.a - p.a) * alpha;
+		slot.attachment = nearest.slots[i].attachment;
+		slot.boneIndex = n.boneIndex;
+		slot.verticesOffset = attachmentVertices.size();
+		if (p.attachment == n.attachment && p.verticesCount == n.verticesCount) {
+			slot.verticesCount = n.verticesCount;
+			for (int ii = 0; ii < n.verticesCount; ++ii) {
+				float pv = from.attachmentVertices[p.verticesOffset + ii], nv = to.attachmentVertices[n.verticesOffset + ii];
+				attachmentVertices.push_back(pv + (nv - pv) * alpha);
+			}
+		} else {
+			const Slot& source = nearest.slots[i];
+			slot.verticesCount = source.verticesCount;
+			attachmentVertices.insert(attachmentVertices.end(),
+				nearest.attachmentVertices.begin() + source.verticesOffset,
+				nearest.attachmentVertices.begin() + source.verticesOffset + source.verticesCount);
+		}
+	}
+
+	drawOrder = nearest.drawOrder;
+}
+
+int ofxSkeletonPose::computeWorldVertices (int slotIndex, float* worldVertices) const {
+	const Slot& slot = slots[slotIndex];
+	if (!slot.attachment) return 0;
+	const Bone& bone = bones[slot.boneIndex];
+	const float* ffd = slot.verticesCount ? &attachmentVertices[slot.verticesOffset] : 0;
+
+	switch (slot.attachment->type) {
+	case SP_ATTACHMENT_REGION: {
+		const spRegionAttachment* region = (const spRegionAttachment*)slot.attachment;
+		const float* offset = region->offset;
+		float wx = x + bone.worldX, wy = y + bone.worldY;
+		for (int i = 0; i < 8; i += 2) {
+			worldVertices[i] = offset[i] * bone.a + offset[i + 1] * bone.b + wx;
+			worldVertices[i + 1] = offset[i] * bone.c + offset[i + 1] * bone.d + wy;
+		}
+		return 8;
+	}
+	case SP_ATTACHMENT_BOUNDING_BOX: {
+		const spBoundingBoxAttachment* box = (const spBoundingBoxAttachment*)slot.attachment;
+		float wx = x + bone.worldX, wy = y + bone.worldY;
+		for (int i = 0; i < box->verticesCount; i += 2) {
+			const float vx = box->vertices[i], vy = box->vertices[i + 1];
+			worldVertices[i] = vx * bone.a + vy * bone.b + wx;
+			worldVertices[i + 1] = vx * bone.c + vy * bone.d + wy;
+		}
+		return box->verticesCount;
+	}
+	case SP_ATTACHMENT_MESH: {
+		const spMeshAttachment* mesh = (const spMeshAttachment*)slot.attachment;
+		const float* vertices = slot.verticesCount == mesh->verticesCount ? ffd : mesh->vertices;
+		float wx = x + bone.worldX, wy = y + bone.worldY;
+		for (int i = 0; i < mesh->verticesCount; i += 2) {
+			const float vx = vertices[i], vy = vertices[i + 1];
+			worldVertices[i] = vx * bone.a + vy * bone.b + wx;
+			worldVertices[i + 1] = vx * bone.c + vy * bone.d + wy;
+		}
+		return mesh->verticesCount;
+	}
+	case SP_ATTACHMENT_WEIGHTED_MESH: {
+		const spWeightedMeshAttachment* mesh = (const spWeightedMeshAttachment*)slot.attachment;
+		int w = 0, v = 0, b = 0, f = 0;
+		while (v < mesh->bonesCount) {
+			float wx = 0, wy = 0;
+			const int nn = mesh->bones[v] + v;
+			v++;
+			for (; v <= nn; v++, b += 3) {
+				const Bone& weightBone = bones[mesh->bones[v]];
+				float vx = mesh->weights[b], vy = mesh->weights[b + 1];
+				const float weight = mesh->weights[b + 2];
+				if (ffd) {
+					vx += ffd[f];
+					vy += ffd[f + 1];
+					f += 2;
+				}
+				wx += (vx * weightBone.a + vy * weightBone.b + weightBone.worldX) * weight;
+				wy += (vx * weightBone.c + vy * weightBone.d + weightBone.worldY) * weight;
+			}
+			worldVertices[w] = wx + x;
+			worldVertices[w + 1] = wy + y;
+			w += 2;
+		}
+		return w;
+	}
+	default:
+		return 0;
+	}
+}
+
+// --- Triple buffer
+
+ofxSkeletonPoseBuffer::ofxSkeletonPoseBuffer()
+	: writeIndex(0), readIndex(2), acquired(0), middle(1) {
+}
+
+void ofxSkeletonPoseBuffer::publish () {
+	int old = middle.exchange(writeIndex | DIRTY, std::memory_order_acq_rel);
+	writeIndex = old & 3;
+}
+
+bool ofxSkeletonPoseBuffer::acquire () {
+	if (!(middle.load(std::memory_order_acquire) & DIRTY)) return false;
+	if (acquired) previous = poses[readIndex];
+	int old = middle.exchange(readIndex, std::memory_order_acq_rel);
+	readIndex = old & 3;
+	if (acquired < 2) acquired++;
+	return true;
+}
@@ -0,0 +1,90 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include <atomic>
+
+/** A copy of everything needed to draw a skeleton: bone transforms, slot colors and attachments, draw order and FFD vertices.
+  * A pose only references the immutable SkeletonData and attachments, so it can be drawn on another thread while the skeleton
+  * it was captured from keeps updating. */
+class ofxSkeletonPose
+{
+public:
+
+	struct Bone
+	{
+		// Local transform.
+		float x, y, rotation, scaleX, scaleY;
+		// World transform, relative to the skeleton position.
+		float a, b, c, d, worldX, worldY;
+	};
+
+	struct Slot
+	{
+		float r, g, b, a;
+		spAttachment* attachment;
+		int boneIndex;
+		int verticesOffset; // Into attachmentVertices.
+		int verticesCount;
+	};
+
+	spSkeletonData* data;
+	float x, y;
+	float r, g, b, a;
+	bool flipX, flipY;
+	vector<Bone> bones;
+	vector<Slot> slots;
+	vector<int> drawOrder; // Slot indices.
+	vector<float> attachmentVertices;
+	/* Free for the caller, eg. the simulation time the pose was captured at. */
+	double time;
+
+	ofxSkeletonPose();
+
+	void capture (const spSkeleton* skeleton);
+	/* Writes the pose back into a skeleton of the same SkeletonData, including the world transforms. */
+	void apply (spSkeleton* skeleton) const;
+	/* Writes only the bone transforms, local and world, leaving slots and draw order alone. */
+	void applyBones (spSkeleton* skeleton) const;
+	/* Blends two poses of the same SkeletonData. Transforms are lerped (matrices component-wise, which is exact for
+	 * translation and close enough for the small rotations between two updates); attachments and draw order come from
+	 * alpha < 0.5 ? from : to. */
+	void interpolate (const ofxSkeletonPose& from, const ofxSkeletonPose& to, float alpha);
+
+	/* Computes the world vertices of the slot's region, mesh or bounding box attachment, like the
+	 * spAttachment_computeWorldVertices functions do for a live skeleton. Returns the number of floats written, 0 if the
+	 * slot has no such attachment. */
+	int computeWorldVertices (int slotIndex, float* worldVertices) const;
+};
+
+/** Lock-free triple buffer of poses for one writer (update) thread and one reader (render) thread. The writer never waits for
+  * the reader; the reader always gets the latest published pose. */
+class ofxSkeletonPoseBuffer
+{
+public:
+	ofxSkeletonPoseBuffer();
+
+	// --- Writer thread.
+	ofxSkeletonPose& getWritePose () { return poses[writeIndex]; }
+	void publish ();
+
+	// --- Reader thread.
+	/* Takes the latest published pose if there is a new one. The pose it replaces is kept as getPreviousPose(). Returns
+	 * false if nothing was published since the last call. */
+	bool acquire ();
+	const ofxSkeletonPose& getPose () const { return poses[readIndex]; }
+	const ofxSkeletonPose& getPreviousPose () const { return previous; }
+	bool hasPose () const { return acquired > 0; }
+	bool hasPreviousPose () const { return acquired > 1; }
+
+private:
+	static const int DIRTY = 4;
+
+	ofxSkeletonPose poses[3];
+	ofxSkeletonPose previous;
+	int writeIndex;
+	int readIndex;
+	int acquired;
+	std::atomic<int> middle;
+};
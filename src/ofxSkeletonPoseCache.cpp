@@ -0,0 +1,94 @@
+#include "ofxSkeletonPoseCache.h"
+
+#include <spine/extension.h>
+
+static const int MIX_STEPS = 32;
+
+bool ofxSkeletonPoseCache::Key::operator== (const Key& other) const {
+	return data == other.data && animation == other.animation && previous == other.previous
+		&& time == other.time && previousTime == other.previousTime && mix == other.mix
+		&& flipX == other.flipX && flipY == other.flipY;
+}
+
+size_t ofxSkeletonPoseCache::KeyHash::operator() (const Key& key) const {
+	size_t hash = std::hash<const void*>()(key.data);
+	hash = hash * 31 + std::hash<const void*>()(key.animation);
+	hash = hash * 31 + std::hash<const void*>()(key.previous);
+	hash = hash * 31 + key.time;
+	hash = hash * 31 + key.previousTime;
+	hash = hash * 31 + key.mix;
+	hash = hash * 4 + (key.flipX ? 2 : 0) + (key.flipY ? 1 : 0);
+	return hash;
+}
+
+shared_ptr<ofxSkeletonPoseCache> ofxSkeletonPoseCache::create (float timeStep) {
+	return make_shared<ofxSkeletonPoseCache>(timeStep);
+}
+
+ofxSkeletonPoseCache::ofxSkeletonPoseCache(float timeStep)
+	: timeStep(timeStep), used(0), hits(0), misses(0), computeMillis(0) {
+}
+
+void ofxSkeletonPoseCache::beginFrame () {
+	entries.clear();
+	used = 0;
+	hits = 0;
+	misses = 0;
+	computeMillis = 0;
+}
+
+/* The time the pose is sampled at, folded into the clip like spAnimation_apply does. */
+static float clipTime (const spTrackEntry* entry) {
+	float time = entry->time;
+	if (!entry->loop && time > entry->endTime) time = entry->endTime;
+	float duration = entry->animation->duration;
+	if (entry->loop && duration > 0) time = FMOD(time, duration);
+	return time;
+}
+
+bool ofxSkeletonPoseCache::makeKey (const spAnimationState* state, const spSkeleton* skeleton, Key& key) const {
+	spTrackEntry* current = state->tracksCount > 0 ? state->tracks[0] : 0;
+	if (!current || !current->animation) return false;
+	for (int i = 1; i < state->tracksCount; ++i)
+		if (state->tracks[i]) return false;
+
+	key.data = skeleton->data;
+	key.animation = current->animation;
+	key.time = (int)floorf(clipTime(current) / timeStep + 0.5f);
+	key.flipX = skeleton->flipX != 0;
+	key.flipY = skeleton->flipY != 0;
+	key.previous = 0;
+	key.previousTime = 0;
+	key.mix = MIX_STEPS;
+
+	spTrackEntry* previous = current->previous;
+	if (previous) {
+		float alpha = current->mixDuration > 0 ? current->mixTime / current->mixDuration * current->mix : 1;
+		if (alpha < 1) {
+			if (!previous->animation) return false;
+			key.previous = previous->animation;
+			key.previousTime = (int)floorf(clipTime(previous) / timeStep + 0.5f);
+			key.mix = (int)(alpha * MIX_STEPS);
+		}
+	} else if (current->mix != 1) {
+		// Mixes with whatever the skeleton held before, which is different for every instance.
+		return false;
+	}
+	return true;
+}
+
+const ofxSkeletonPose* ofxSkeletonPoseCache::find (const Key& key) {
+	auto entry = entries.find(key);
+	if (entry == entries.end()) return 0;
+	hits++;
+	return &poses[entry->second];
+}
+
+void ofxSkeletonPoseCache::store (const Key& key, const spSkeleton* skeleton, double millis) {
+	misses++;
+	computeMillis += millis;
+	if (used == (int)poses.size()) poses.push_back(ofxSkeletonPose());
+	poses[used].capture(skeleton);
+	entries[key] = used;
+	used++;
+}
@@ -0,0 +1,75 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include "ofxSkeletonPose.h"
+
+/** Shares bone poses between instances of the same SkeletonData playing the same clip at the same (quantized) time. The first
+  * instance to reach a key computes the pose as usual and stores it; the others copy its bone transforms instead of running
+  * the bone timelines and spSkeleton_updateWorldTransform.
+  *
+  * What is shared and what is not:
+  * - Bones, local and world transforms, come from the instance that computed the entry, including bones the clip does not
+  *   key. Bones changed by hand on one instance are overwritten on a hit.
+  * - Slots are never shared. Each instance applies the clip's color, attachment, FFD and draw order timelines to its own
+  *   slots at its own exact time, so per-instance attachments (setAttachment, queued commands), skins and slot colors stay.
+  *   Skins do not change bones, so instances with different skins share poses.
+  * - Events and completion are fired per instance. Position, instance transform and color are per instance.
+  *
+  * Only single-track states are cached (track 0, optionally mixing from a previous entry). Not thread-safe: update the
+  * instances sharing a cache on one thread. */
+class ofxSkeletonPoseCache
+{
+public:
+
+	struct Key
+	{
+		spSkeletonData* data;
+		spAnimation* animation;
+		spAnimation* previous;
+		int time;
+		int previousTime;
+		int mix;
+		bool flipX, flipY;
+
+		bool operator== (const Key& other) const;
+	};
+
+	static shared_ptr<ofxSkeletonPoseCache> create (float timeStep = 1 / 60.0f);
+
+	/* @param timeStep Animation times are rounded to multiples of timeStep; mixes to 1/32 steps. */
+	ofxSkeletonPoseCache(float timeStep = 1 / 60.0f);
+
+	/* Drops the poses and counters of the previous frame. Call once per frame before updating the instances. */
+	void beginFrame ();
+
+	/* Returns false if the state can not be cached. */
+	bool makeKey (const spAnimationState* state, const spSkeleton* skeleton, Key& key) const;
+	/* Returns 0 on a miss. */
+	const ofxSkeletonPose* find (const Key& key);
+	/* @param computeMillis What computing the pose cost, used to estimate the time saved by hits. */
+	void store (const Key& key, const spSkeleton* skeleton, double computeMillis);
+
+	int getHits () const { return hits; }
+	int getMisses () const { return misses; }
+	float getHitRate () const { return hits + misses ? hits / (float)(hits + misses) : 0; }
+	/* Estimated CPU milliseconds saved this frame: hits times the average cost of a miss. */
+	double getSavedMillis () const { return misses ? hits * computeMillis / misses : 0; }
+	int getPosesCount () const { return used; }
+
+	float timeStep;
+
+private:
+	struct KeyHash
+	{
+		size_t operator() (const Key& key) const;
+	};
+
+	unordered_map<Key, int, KeyHash> entries;
+	vector<ofxSkeletonPose> poses; // Reused between frames.
+	int used;
+	int hits;
+	int misses;
+	double computeMillis;
+};
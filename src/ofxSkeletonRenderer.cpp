@@ -30,6 +30,7 @@
  *****************************************************************************/
 
 #include "ofxSkeletonRenderer.h"
+#include "ofxSpineTextureResidency.h"
 #include <spine/extension.h>
 #include <algorithm>
 
@@ -52,8 +53,17 @@ shared_ptr<ofxSkeletonRenderer> ofxSkeletonRenderer::createWithFile (const char*
 
 void ofxSkeletonRenderer::initialize () {
 	worldVertices = MALLOC(float, 1000); // Max number of vertices per mesh.
+	poseVertices = MALLOC(float, 1000);
+	blendMode = -1;
+	drawList = 0;
+	drawListTag = 0;
+	drawListOverlay = 0;
+	drawnSnapshot = 0;
+	hasTransform = false;
+	resetBounds();
 
 	batch = ofxPolygonBatch::createWithCapacity(2000); // Max number of vertices and triangles per batch.
+	batch->setStats(&stats);
 
 	blendFunc.src = GL_SRC_ALPHA;
 	blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
@@ -90,9 +100,6 @@ ofxSkeletonRenderer::ofxSkeletonRenderer(const char* skeletonDataFile, spAtlas*
 	spSkeletonJson_dispose(json);
 
 	setSkeletonData(skeletonData, true);
-
-	//- TODO
-	this->scale = ofVec2f(scale, scale);
 }
 
 ofxSkeletonRenderer::ofxSkeletonRenderer(const char* skeletonDataFile, const char* atlasFile, float scale)
@@ -136,10 +143,12 @@ ofxSkeletonRenderer::~ofxSkeletonRenderer() {
 	if (atlas) spAtlas_dispose(atlas);
 	spSkeleton_dispose(skeleton);
 	FREE(worldVertices);
+	FREE(poseVertices);
 	batch.reset();
 }
 
 void ofxSkeletonRenderer::update (float deltaTime) {
+	stats.reset();
 	spSkeleton_update(skeleton, deltaTime * timeScale);
 }
 
@@ -147,154 +156,356 @@ void ofxSkeletonRenderer::draw () {
 	//CC_NODE_DRAW_SETUP();
 	//ccGLBindVAO(0);
 
+	if (poseBuffer) {
+		drawSnapshot(1);
+		return;
+	}
+
 	skeleton->r = color.r / (float)255;
 	skeleton->g = color.g / (float)255;
 	skeleton->b = color.b / (float)255;
 	skeleton->a = color.a / (float)255;
 
-	int blendMode = -1;
-	ofColor color;
-	const float* uvs = nullptr;
-	int verticesCount = 0;
-	const int* triangles = nullptr;
-	int trianglesCount = 0;
-	float r = 0, g = 0, b = 0, a = 0;
-	for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
-		spSlot* slot = skeleton->drawOrder[i];
-		
-		if (!slot->attachment) continue;
-		ofTexture *texture = nullptr;
-		switch (slot->attachment->type) {
-		case SP_ATTACHMENT_REGION: {
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = 8;
-			triangles = quadTriangles;
-			trianglesCount = 6;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_MESH: {
-			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
-			spMeshAttachment_computeWorldVertices(attachment, slot, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->verticesCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		case SP_ATTACHMENT_WEIGHTED_MESH: {
-			spWeightedMeshAttachment* attachment = (spWeightedMeshAttachment*)slot->attachment;
-			spWeightedMeshAttachment_computeWorldVertices(attachment, slot, worldVertices);
-			texture = getTexture(attachment);
-			uvs = attachment->uvs;
-			verticesCount = attachment->uvsCount;
-			triangles = attachment->triangles;
-			trianglesCount = attachment->trianglesCount;
-			r = attachment->r;
-			g = attachment->g;
-			b = attachment->b;
-			a = attachment->a;
-			break;
-		}
-		}
-		if (texture) {
-			if (slot->data->blendMode != blendMode) {
-				//batch->flush();
-				blendMode = slot->data->blendMode;
-				//glEnable(GL_BLEND);
-				switch (slot->data->blendMode) {
-				case SP_BLEND_MODE_ADDITIVE:
-					glBlendFunc(premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA, GL_ONE);
-					break;
-				case SP_BLEND_MODE_MULTIPLY:
-					glBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
-					break;
-				case SP_BLEND_MODE_SCREEN:
-					glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
-					break;
-				default:
-					glBlendFunc(blendFunc.src, blendFunc.dst);
-				}
+	blendMode = -1;
+	updateTransformMatrix();
+	resetBounds();
+	AttachmentGeometry geometry;
+	{
+		// Batches flushed on texture, blend or capacity changes count as submitTime.
+		OFX_SPINE_TIMER_EXCLUDING(&stats, vertexTime, submitTime);
+		for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
+			spSlot* slot = skeleton->drawOrder[i];
+			if (slot->attachment && slot->attachment->type == SP_ATTACHMENT_BOUNDING_BOX) {
+				// Not drawn, but hit tests use the cached bounds as their broad phase.
+				spBoundingBoxAttachment* box = (spBoundingBoxAttachment*)slot->attachment;
+				spBoundingBoxAttachment_computeWorldVertices(box, slot->bone, worldVertices);
+				addToBounds(worldVertices, box->verticesCount);
+				continue;
+			}
+			if (!slot->attachment || !getAttachmentGeometry(slot->attachment, geometry)) continue;
+			switch (slot->attachment->type) {
+			case SP_ATTACHMENT_REGION:
+				spRegionAttachment_computeWorldVertices((spRegionAttachment*)slot->attachment, slot->bone, worldVertices);
+				break;
+			case SP_ATTACHMENT_MESH:
+				spMeshAttachment_computeWorldVertices((spMeshAttachment*)slot->attachment, slot, worldVertices);
+				break;
+			case SP_ATTACHMENT_WEIGHTED_MESH:
+				spWeightedMeshAttachment_computeWorldVertices((spWeightedMeshAttachment*)slot->attachment, slot, worldVertices);
+				break;
+			default:
+				continue;
 			}
-			color.a = skeleton->a * slot->a * a * 255;
-			float multiplier = premultipliedAlpha ? color.a : 255;
-			color.r = skeleton->r * slot->r * r * multiplier;
-			color.g = skeleton->g * slot->g * g * multiplier;
-			color.b = skeleton->b * slot->b * b * multiplier;
-			batch->add(texture, worldVertices, uvs, verticesCount, triangles, trianglesCount, color);
+			addToBounds(worldVertices, geometry.verticesCount);
+			addToBatch(slot->data->blendMode, geometry, worldVertices,
+				skeleton->r * slot->r, skeleton->g * slot->g, skeleton->b * slot->b, skeleton->a * slot->a);
 		}
 	}
 	batch->draw();
 
-	if (debugSlots) {
-		// Slots.
-		ofSetColor(0, 0, 255, 255);
-		ofSetLineWidth(1);
-		ofPolyline poly;
-		for (int i = 0, n = skeleton->slotsCount; i < n; i++) {
-			spSlot* slot = skeleton->drawOrder[i];
-			if (!slot->attachment || slot->attachment->type != SP_ATTACHMENT_REGION) continue;
-			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
-			poly.addVertex(ofPoint(worldVertices[0], worldVertices[1]));
-			poly.addVertex(ofPoint(worldVertices[2], worldVertices[3]));
-			poly.addVertex(ofPoint(worldVertices[4], worldVertices[5]));
-			poly.addVertex(ofPoint(worldVertices[6], worldVertices[7]));
-			poly.draw();
+	drawDebug(0);
+	ofSetColor(255);
+}
+
+void ofxSkeletonRenderer::drawPose (const ofxSkeletonPose& pose) {
+	if (pose.data != skeleton->data) return;
+
+	float r = color.r / (float)255, g = color.g / (float)255, b = color.b / (float)255, a = color.a / (float)255;
+	blendMode = -1;
+	updateTransformMatrix();
+	resetBounds();
+	AttachmentGeometry geometry;
+	{
+		OFX_SPINE_TIMER_EXCLUDING(&stats, vertexTime, submitTime);
+		for (size_t i = 0; i < pose.drawOrder.size(); i++) {
+			int slotIndex = pose.drawOrder[i];
+			const ofxSkeletonPose::Slot& slot = pose.slots[slotIndex];
+			if (slot.attachment && slot.attachment->type == SP_ATTACHMENT_BOUNDING_BOX) {
+				addToBounds(poseVertices, pose.computeWorldVertices(slotIndex, poseVertices));
+				continue;
+			}
+			if (!slot.attachment || !getAttachmentGeometry(slot.attachment, geometry)) continue;
+			if (!pose.computeWorldVertices(slotIndex, poseVertices)) continue;
+			addToBounds(poseVertices, geometry.verticesCount);
+			addToBatch(pose.data->slots[slotIndex]->blendMode, geometry, poseVertices, r * slot.r, g * slot.g, b * slot.b, a * slot.a);
 		}
 	}
-	if (debugBones) {
-		// Bone lengths.
-		ofSetLineWidth(2);
-		ofSetColor(255, 0, 0, 255);
-		for (int i = 0, n = skeleton->bonesCount; i < n; i++) {
-			spBone *bone = skeleton->bones[i];
-			float x = bone->data->length * bone->a + bone->worldX;
-			float y = bone->data->length * bone->c + bone->worldY;
-			ofDrawLine(ofVec2f(bone->worldX, bone->worldY), ofVec2f(x, y));
-		}
-		// Bone origins.
-		ofSetColor(0, 0, 255, 255); // Root bone is blue.
-		for (int i = 0, n = skeleton->bonesCount; i < n; i++) {
-			spBone *bone = skeleton->bones[i];
-			ofDrawCircle(ofVec2f(bone->worldX, bone->worldY), 4);
-			if (i == 0) ofSetColor(0, 255, 0, 255);
+	batch->draw();
+
+	drawDebug(&pose);
+	ofSetColor(255);
+}
+
+void ofxSkeletonRenderer::drawDebug (const ofxSkeletonPose* pose) {
+	if (!debugSlots && !debugBones) return;
+	ofMatrix4x4 matrix = transform.getMatrix4x4();
+	// Only what this renderer asks for, whatever else a shared overlay draws for others.
+	int categories = (debugSlots ? ofxSkeletonDebugOverlay::SLOTS | ofxSkeletonDebugOverlay::MESHES : 0)
+		| (debugBones ? ofxSkeletonDebugOverlay::BONES | ofxSkeletonDebugOverlay::ORIGINS : 0);
+	ofxSkeletonDebugOverlay* overlay;
+	if (drawList) {
+		// Collecting draws nothing, the collector draws its overlay after the list.
+		overlay = drawListOverlay;
+	} else if (debugOverlay) {
+		// Drawn by whoever owns the shared overlay.
+		overlay = debugOverlay.get();
+	} else {
+		if (!ownDebugOverlay) ownDebugOverlay = ofxSkeletonDebugOverlay::create();
+		overlay = ownDebugOverlay.get();
+	}
+	if (!overlay) return;
+	if (pose) overlay->add(*pose, matrix, categories);
+	else overlay->add(skeleton, matrix, categories);
+	if (overlay == ownDebugOverlay.get()) overlay->draw();
+}
+
+void ofxSkeletonRenderer::updateTransformMatrix () {
+	hasTransform = !transform.isIdentity();
+	if (hasTransform) transform.getMatrix(transformMatrix);
+}
+
+void ofxSkeletonRenderer::resetBounds () {
+	localBounds[0] = localBounds[1] = FLT_MAX;
+	localBounds[2] = localBounds[3] = -FLT_MAX;
+}
+
+void ofxSkeletonRenderer::addToBounds (const float* vertices, int verticesCount) {
+	for (int i = 0; i < verticesCount; i += 2) {
+		localBounds[0] = min(localBounds[0], vertices[i]);
+		localBounds[1] = min(localBounds[1], vertices[i + 1]);
+		localBounds[2] = max(localBounds[2], vertices[i]);
+		localBounds[3] = max(localBounds[3], vertices[i + 1]);
+	}
+}
+
+ofRectangle ofxSkeletonRenderer::getCachedBounds () const {
+	if (localBounds[0] > localBounds[2]) return ofRectangle(transform.x, transform.y, 0, 0);
+	if (transform.isIdentity())
+		return ofRectangle(localBounds[0], localBounds[1], localBounds[2] - localBounds[0], localBounds[3] - localBounds[1]);
+	float m[6];
+	transform.getMatrix(m);
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	for (int i = 0; i < 4; ++i) {
+		float vx = localBounds[i & 1 ? 2 : 0], vy = localBounds[i & 2 ? 3 : 1];
+		float x = m[0] * vx + m[1] * vy + m[2], y = m[3] * vx + m[4] * vy + m[5];
+		minX = min(minX, x);
+		minY = min(minY, y);
+		maxX = max(maxX, x);
+		maxY = max(maxY, y);
+	}
+	return ofRectangle(minX, minY, maxX - minX, maxY - minY);
+}
+
+ofVec2f ofxSkeletonRenderer::getWorldPosition () const {
+	return transform.apply(ofVec2f(skeleton->x + rootBone->worldX, skeleton->y + rootBone->worldY));
+}
+
+void ofxSkeletonRenderer::setSnapshotsEnabled (bool enabled) {
+	if (enabled && !poseBuffer) {
+		poseBuffer = make_shared<ofxSkeletonPoseBuffer>();
+		publishSnapshot();
+	} else if (!enabled) {
+		poseBuffer.reset();
+		drawnSnapshot = 0;
+	}
+}
+
+void ofxSkeletonRenderer::publishSnapshot () {
+	if (!poseBuffer) return;
+	ofxSkeletonPose& pose = poseBuffer->getWritePose();
+	pose.capture(skeleton);
+	pose.time = skeleton->time;
+	poseBuffer->publish();
+}
+
+void ofxSkeletonRenderer::drawSnapshot (float alpha) {
+	if (!poseBuffer) return;
+	poseBuffer->acquire();
+	if (!poseBuffer->hasPose()) return;
+	if (alpha < 1 && poseBuffer->hasPreviousPose()) {
+		interpolatedPose.interpolate(poseBuffer->getPreviousPose(), poseBuffer->getPose(), alpha);
+		drawnSnapshot = &interpolatedPose;
+	} else {
+		drawnSnapshot = &poseBuffer->getPose();
+	}
+	drawPose(*drawnSnapshot);
+}
+
+bool ofxSkeletonRenderer::getAttachmentGeometry (spAttachment* attachment, AttachmentGeometry& geometry) const {
+	switch (attachment->type) {
+	case SP_ATTACHMENT_REGION: {
+		spRegionAttachment* region = (spRegionAttachment*)attachment;
+		geometry.texture = getTexture(region);
+		geometry.uvs = region->uvs;
+		geometry.verticesCount = 8;
+		geometry.triangles = quadTriangles;
+		geometry.trianglesCount = 6;
+		geometry.r = region->r;
+		geometry.g = region->g;
+		geometry.b = region->b;
+		geometry.a = region->a;
+		break;
+	}
+	case SP_ATTACHMENT_MESH: {
+		spMeshAttachment* mesh = (spMeshAttachment*)attachment;
+		geometry.texture = getTexture(mesh);
+		geometry.uvs = mesh->uvs;
+		geometry.verticesCount = mesh->verticesCount;
+		geometry.triangles = mesh->triangles;
+		geometry.trianglesCount = mesh->trianglesCount;
+		geometry.r = mesh->r;
+		geometry.g = mesh->g;
+		geometry.b = mesh->b;
+		geometry.a = mesh->a;
+		break;
+	}
+	case SP_ATTACHMENT_WEIGHTED_MESH: {
+		spWeightedMeshAttachment* mesh = (spWeightedMeshAttachment*)attachment;
+		geometry.texture = getTexture(mesh);
+		geometry.uvs = mesh->uvs;
+		geometry.verticesCount = mesh->uvsCount;
+		geometry.triangles = mesh->triangles;
+		geometry.trianglesCount = mesh->trianglesCount;
+		geometry.r = mesh->r;
+		geometry.g = mesh->g;
+		geometry.b = mesh->b;
+		geometry.a = mesh->a;
+		break;
+	}
+	default:
+		return false;
+	}
+	return geometry.texture != nullptr;
+}
+
+/* The GL blend function of a slot blend mode. */
+static void getBlendFunc (int slotBlendMode, bool premultipliedAlpha, const ofxSkeletonRenderer::SkelBlendFunc& normal,
+	GLuint& src, GLuint& dst)
+{
+	switch (slotBlendMode) {
+	case SP_BLEND_MODE_ADDITIVE:
+		src = premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+		dst = GL_ONE;
+		break;
+	case SP_BLEND_MODE_MULTIPLY:
+		src = GL_DST_COLOR;
+		dst = GL_ONE_MINUS_SRC_ALPHA;
+		break;
+	case SP_BLEND_MODE_SCREEN:
+		src = GL_ONE;
+		dst = GL_ONE_MINUS_SRC_COLOR;
+		break;
+	default:
+		src = normal.src;
+		dst = normal.dst;
+	}
+}
+
+void ofxSkeletonRenderer::addToBatch (int slotBlendMode, const AttachmentGeometry& geometry, const float* vertices,
+	float r, float g, float b, float a)
+{
+	ofColor color;
+	color.a = a * geometry.a * 255;
+	float multiplier = premultipliedAlpha ? color.a : 255;
+	color.r = r * geometry.r * multiplier;
+	color.g = g * geometry.g * multiplier;
+	color.b = b * geometry.b * multiplier;
+
+	if (drawList) {
+		ofxSkeletonDrawList::Item item;
+		item.texture = geometry.texture;
+		getBlendFunc(slotBlendMode, premultipliedAlpha, blendFunc, item.blendSrc, item.blendDst);
+		item.uvs = geometry.uvs;
+		item.verticesCount = geometry.verticesCount;
+		item.triangles = geometry.triangles;
+		item.trianglesCount = geometry.trianglesCount;
+		item.verticesOffset = drawList->vertices.size();
+		item.color = color;
+		item.tag = drawListTag;
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+		for (int i = 0; i < geometry.verticesCount; i += 2) {
+			float x = vertices[i], y = vertices[i + 1];
+			if (hasTransform) {
+				x = transformMatrix[0] * vertices[i] + transformMatrix[1] * vertices[i + 1] + transformMatrix[2];
+				y = transformMatrix[3] * vertices[i] + transformMatrix[4] * vertices[i + 1] + transformMatrix[5];
+			}
+			drawList->vertices.push_back(x);
+			drawList->vertices.push_back(y);
+			minX = min(minX, x);
+			minY = min(minY, y);
+			maxX = max(maxX, x);
+			maxY = max(maxY, y);
 		}
+		item.bounds.set(minX, minY, maxX - minX, maxY - minY);
+		drawList->items.push_back(item);
+		return;
 	}
-	ofSetColor(255);
+
+	if (slotBlendMode != blendMode) {
+		batch->draw();
+		OFX_SPINE_COUNT(&stats, blendSwitches, 1);
+		blendMode = slotBlendMode;
+		//glEnable(GL_BLEND);
+		GLuint src, dst;
+		getBlendFunc(slotBlendMode, premultipliedAlpha, blendFunc, src, dst);
+		glBlendFunc(src, dst);
+	}
+	batch->add(geometry.texture, vertices, geometry.uvs, geometry.verticesCount, geometry.triangles, geometry.trianglesCount, color,
+		hasTransform ? transformMatrix : 0);
+}
+
+void ofxSkeletonRenderer::collect (ofxSkeletonDrawList& list, int tag, ofxSkeletonDebugOverlay* overlay) {
+	drawList = &list;
+	drawListTag = tag;
+	drawListOverlay = overlay;
+	draw();
+	drawList = 0;
+	drawListOverlay = 0;
+}
+
+void ofxSkeletonRenderer::collectCurrent (ofxSkeletonDrawList& list, int tag) {
+	drawList = &list;
+	drawListTag = tag;
+	drawListOverlay = 0;
+	if (!poseBuffer) draw();
+	else if (poseBuffer->hasPose()) drawPose(poseBuffer->getPose());
+	drawList = 0;
 }
 
 ofTexture* ofxSkeletonRenderer::getTexture (spRegionAttachment* attachment) const {
-	return (ofTexture*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+	return getTexture(((spAtlasRegion*)attachment->rendererObject)->page);
 }
 
 ofTexture* ofxSkeletonRenderer::getTexture (spMeshAttachment* attachment) const {
-	return (ofTexture*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+	return getTexture(((spAtlasRegion*)attachment->rendererObject)->page);
 }
 
 ofTexture* ofxSkeletonRenderer::getTexture (spWeightedMeshAttachment* attachment) const {
-	return (ofTexture*)((spAtlasRegion*)attachment->rendererObject)->page->rendererObject;
+	return getTexture(((spAtlasRegion*)attachment->rendererObject)->page);
+}
+
+ofTexture* ofxSkeletonRenderer::getTexture (const spAtlasPage* page) const {
+	if (!page->rendererObject) return 0;
+	ofxSpinePageTexture* texture = ofxSpinePageTexture::get(page);
+	return texture->residency ? texture->residency->touch(page) : texture;
 }
 
 ofRectangle ofxSkeletonRenderer::boundingBox () {
-	float minX = FLT_MAX, minY = FLT_MAX, maxX = FLT_MIN, maxY = FLT_MIN;
-	float scaleX = scale.x, scaleY = scale.y;
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float m[6];
+	transform.getMatrix(m);
+	resetBounds();
 	for (int i = 0; i < skeleton->slotsCount; ++i) {
 		spSlot* slot = skeleton->slots[i];
 		if (!slot->attachment) continue;
 		int verticesCount;
-		if (slot->attachment->type == SP_ATTACHMENT_REGION) {
+		if (slot->attachment->type == SP_ATTACHMENT_BOUNDING_BOX) {
+			// Cached for hit tests only, the returned box is what is drawn.
+			spBoundingBoxAttachment* box = (spBoundingBoxAttachment*)slot->attachment;
+			spBoundingBoxAttachment_computeWorldVertices(box, slot->bone, worldVertices);
+			addToBounds(worldVertices, box->verticesCount);
+			continue;
+		} else if (slot->attachment->type == SP_ATTACHMENT_REGION) {
 			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
 			spRegionAttachment_computeWorldVertices(attachment, slot->bone, worldVertices);
 			verticesCount = 8;
@@ -308,15 +519,18 @@ ofRectangle ofxSkeletonRenderer::boundingBox () {
 			verticesCount = mesh->uvsCount;
 		} else
 			continue;
+		addToBounds(worldVertices, verticesCount);
 		for (int ii = 0; ii < verticesCount; ii += 2) {
-			float x = worldVertices[ii] * scaleX, y = worldVertices[ii + 1] * scaleY;
+			float vx = worldVertices[ii], vy = worldVertices[ii + 1];
+			float x = m[0] * vx + m[1] * vy + m[2], y = m[3] * vx + m[4] * vy + m[5];
 			minX = min(minX, x);
 			minY = min(minY, y);
 			maxX = max(maxX, x);
 			maxY = max(maxY, y);
 		}
 	}
-	return ofRectangle(position.x + minX, position.y + minY, maxX - minX, maxY - minY);
+	if (minX > maxX) return ofRectangle(transform.x, transform.y, 0, 0);
+	return ofRectangle(minX, minY, maxX - minX, maxY - minY);
 }
 
 // --- Convenience methods for Skeleton_* functions.
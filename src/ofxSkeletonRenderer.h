@@ -4,6 +4,11 @@
 #include <spine/spine.h>
 #include "ofMain.h"
 #include "ofxPolygonBatch.h"
+#include "ofxSpineStats.h"
+#include "ofxSkeletonPose.h"
+#include "ofxSkeletonDebugOverlay.h"
+#include "ofxSkeletonTransform.h"
+#include "ofxSkeletonDrawList.h"
 
 /** Draws a skeleton. */
 class ofxSkeletonRenderer
@@ -23,6 +28,9 @@ public:
 	bool debugBones;
 	bool premultipliedAlpha;
 
+	/* Counters and timings since the start of the last update(). */
+	ofxSpineStats stats;
+
 	static shared_ptr<ofxSkeletonRenderer> createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData = false);
 	static shared_ptr<ofxSkeletonRenderer> createWithFile (const char* skeletonDataFile, spAtlas* atlas, float scale = 0);
 	static shared_ptr<ofxSkeletonRenderer> createWithFile (const char* skeletonDataFile, const char* atlasFile, float scale = 0);
@@ -36,6 +44,38 @@ public:
 	virtual void update (float deltaTime);
 	virtual void draw ();
 	virtual ofRectangle boundingBox();
+	/* Bounds of the vertices written by the last draw() or boundingBox(), and of the bounding box attachments, with the
+	 * current instance transform applied. Costs no vertex work, so it may be called every frame for culling and picking.
+	 * Axis-aligned around the rotated box, so it is larger than boundingBox() when the instance is rotated. */
+	ofRectangle getCachedBounds () const;
+
+	/* With debugSlots or debugBones set, draw() adds to this overlay instead of drawing its own, so the debug geometry of
+	 * many skeletons is drawn at once by overlay->draw(). May be 0 (default). */
+	void setDebugOverlay (shared_ptr<ofxSkeletonDebugOverlay> overlay) { debugOverlay = overlay; }
+	shared_ptr<ofxSkeletonDebugOverlay> getDebugOverlay () const { return debugOverlay; }
+
+	// --- Pose snapshots, for drawing on another thread than update().
+	/* When enabled, ofxSkeletonAnimation::update() publishes a snapshot of the final pose and draw() draws the latest
+	 * snapshot instead of the live skeleton, so the next update can run while the previous frame is drawn. */
+	void setSnapshotsEnabled (bool enabled);
+	bool getSnapshotsEnabled () const { return poseBuffer != nullptr; }
+	/* Captures the skeleton into the snapshot buffer. Call after changing the skeleton outside of update(). */
+	void publishSnapshot ();
+	/* The snapshot pose the last draw() drew, 0 before the first or without snapshots. Hit tests use it so they agree
+	 * with what is on screen. */
+	const ofxSkeletonPose* getDrawnSnapshot () const { return drawnSnapshot; }
+	/* Draws the latest snapshot. alpha < 1 blends from the previous snapshot, for rendering faster than updating. */
+	void drawSnapshot (float alpha = 1);
+	/* Draws a pose of this skeleton's SkeletonData instead of the skeleton itself. */
+	void drawPose (const ofxSkeletonPose& pose);
+
+	/* Appends what draw() would draw to the list instead of drawing it, for merging with other skeletons (ofxSkeletonScene).
+	 * Nothing is drawn. With debugSlots or debugBones set, the debug geometry is added to overlay (may be 0), for the
+	 * caller to draw after the list. */
+	void collect (ofxSkeletonDrawList& list, int tag = 0, ofxSkeletonDebugOverlay* overlay = 0);
+	/* Like collect() without side effects, for exporting what was drawn: a snapshot renderer collects the snapshot the last
+	 * draw() acquired instead of acquiring a new one, and no debug geometry is added. */
+	void collectCurrent (ofxSkeletonDrawList& list, int tag = 0);
 
 	// --- Convenience methods for common Skeleton_* functions.
 	void updateWorldTransform ();
@@ -66,40 +106,89 @@ public:
 	virtual void setOpacityModifyRGB (bool value);
 	virtual bool isOpacityModifyRGB ();
 
-	ofVec2f getPosition() {
-		return ofVec2f(skeleton->x, skeleton->y);
-	}
+	// --- Instance transform. Applied when the vertices are written, so moving an instance neither recomputes the bones nor
+	// needs ofPushMatrix / ofTranslate around draw(). Debug geometry and boundingBox() include it.
+	ofxSkeletonTransform transform;
 
-	ofVec2f getWorldPosition() {
-		return ofVec2f(rootBone->worldX, rootBone->worldY);
-	}
+	void setTransform(const ofxSkeletonTransform& t) { transform = t; }
+	const ofxSkeletonTransform& getTransform() const { return transform; }
 
-	void setPoision(ofVec2f v) {
-		position = v; 
-		skeleton->x = position.x;
-		skeleton->y = position.y;
-		updateWorldTransform();
+	ofVec2f getPosition() const {
+		return ofVec2f(transform.x, transform.y);
+	}
+	void setPosition(ofVec2f v) {
+		transform.x = v.x;
+		transform.y = v.y;
+	}
+	/* Same as setPosition, kept for existing code. */
+	void setPoision(ofVec2f v) { setPosition(v); }
+	void setRotation(float degrees) { transform.rotation = degrees; }
+	void setScale(ofVec2f s) {
+		transform.scaleX = s.x;
+		transform.scaleY = s.y;
+	}
+	void setFlip(bool flipX, bool flipY) {
+		transform.flipX = flipX;
+		transform.flipY = flipY;
 	}
+
+	/* Root bone position, with the instance transform applied. */
+	ofVec2f getWorldPosition() const;
+
 	void setColor(ofColor c) { color = c; }
-	//void setScale(ofVec2f s) { scale = s; }
 
 protected:
+	/* Texture, uvs, triangles and color of a region or mesh attachment. */
+	struct AttachmentGeometry
+	{
+		ofTexture* texture;
+		const float* uvs;
+		int verticesCount;
+		const int* triangles;
+		int trianglesCount;
+		float r, g, b, a;
+	};
+
 	ofxSkeletonRenderer();
 	void setSkeletonData (spSkeletonData* skeletonData, bool ownsSkeletonData);
 
+	/* Returns false if the attachment is not drawable or its texture is not loaded. */
+	bool getAttachmentGeometry (spAttachment* attachment, AttachmentGeometry& geometry) const;
+
 	virtual ofTexture* getTexture (spRegionAttachment* attachment) const;
 	virtual ofTexture* getTexture (spMeshAttachment* attachment) const;
 	virtual ofTexture* getTexture (spWeightedMeshAttachment* attachment) const;
+	/* Goes through the residency manager the page was registered with, see ofxSpineSetTextureResidency. */
+	ofTexture* getTexture (const spAtlasPage* page) const;
 
 private:
 	bool ownsSkeletonData;
 	spAtlas* atlas;
 	float* worldVertices;
+	float* poseVertices;
 	void initialize ();
+	void addToBatch (int slotBlendMode, const AttachmentGeometry& geometry, const float* vertices, float r, float g, float b, float a);
+
+	void drawDebug (const ofxSkeletonPose* pose);
+
+	int blendMode;
+	ofxSkeletonDrawList* drawList; // Set during collect().
+	int drawListTag;
+	ofxSkeletonDebugOverlay* drawListOverlay;
+	shared_ptr<ofxSkeletonDebugOverlay> debugOverlay;
+	shared_ptr<ofxSkeletonDebugOverlay> ownDebugOverlay;
+	shared_ptr<ofxSkeletonPoseBuffer> poseBuffer;
+	ofxSkeletonPose interpolatedPose;
+	const ofxSkeletonPose* drawnSnapshot;
+
+	void updateTransformMatrix ();
+	bool hasTransform;
+	float transformMatrix[6];
+	float localBounds[4]; // minX, minY, maxX, maxY before the instance transform.
+	void resetBounds ();
+	void addToBounds (const float* vertices, int verticesCount);
 
 	shared_ptr<ofxPolygonBatch> batch;
-	ofVec2f position;
 	ofColor color;
-	ofVec2f scale;
 };
 
@@ -0,0 +1,113 @@
+#include "ofxSkeletonScene.h"
+
+shared_ptr<ofxSkeletonScene> ofxSkeletonScene::create () {
+	return make_shared<ofxSkeletonScene>();
+}
+
+ofxSkeletonScene::ofxSkeletonScene()
+	: reorder(true), maxLookback(16), orders(0) {
+	batch = ofxPolygonBatch::createWithCapacity(2000);
+	batch->setStats(&stats);
+	debugOverlay = ofxSkeletonDebugOverlay::create();
+	memset(&sceneStats, 0, sizeof(sceneStats));
+}
+
+void ofxSkeletonScene::add (shared_ptr<ofxSkeletonRenderer> instance, int layer, float depth) {
+	if (!instance) return;
+	Entry entry = { instance, layer, depth, orders++ };
+	entries.push_back(entry);
+}
+
+void ofxSkeletonScene::remove (shared_ptr<ofxSkeletonRenderer> instance) {
+	for (size_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].instance != instance) continue;
+		entries.erase(entries.begin() + i);
+		return;
+	}
+}
+
+void ofxSkeletonScene::clear () {
+	entries.clear();
+}
+
+void ofxSkeletonScene::setSortKey (shared_ptr<ofxSkeletonRenderer> instance, int layer, float depth) {
+	for (size_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].instance != instance) continue;
+		entries[i].layer = layer;
+		entries[i].depth = depth;
+		return;
+	}
+}
+
+void ofxSkeletonScene::draw () {
+	stats.reset();
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+		if (a.layer != b.layer) return a.layer < b.layer;
+		if (a.depth != b.depth) return a.depth < b.depth;
+		return a.order < b.order;
+	});
+
+	list.clear();
+	// The renderers time their own vertices.
+	for (size_t i = 0; i < entries.size(); ++i) entries[i].instance->collect(list, i, debugOverlay.get());
+
+	const vector<ofxSkeletonDrawList::Item>& items = list.items;
+	int count = items.size();
+	sceneStats.instances = entries.size();
+	sceneStats.attachments = count;
+	sceneStats.batchesBefore = 0;
+	for (int i = 0; i < count; ++i)
+		if (i == 0 || !ofxSkeletonDrawList::canBatch(items[i - 1], items[i])) sceneStats.batchesBefore++;
+
+	// Each item joins the latest compatible batch it can reach without passing over an overlapping one.
+	batches.clear();
+	next.assign(count, -1);
+	for (int i = 0; i < count; ++i) {
+		const ofxSkeletonDrawList::Item& item = items[i];
+		int target = -1;
+		if (!batches.empty() && ofxSkeletonDrawList::canBatch(items[batches.back().last], item)) {
+			target = batches.size() - 1;
+		} else if (reorder) {
+			int stop = max(0, (int)batches.size() - maxLookback);
+			for (int b = batches.size() - 1; b >= stop; --b) {
+				if (ofxSkeletonDrawList::canBatch(items[batches[b].first], item)) {
+					target = b;
+					break;
+				}
+				if (batches[b].bounds.intersects(item.bounds)) break;
+			}
+		}
+		if (target < 0) {
+			Batch created = { i, i, item.bounds };
+			batches.push_back(created);
+			continue;
+		}
+		Batch& joined = batches[target];
+		next[joined.last] = i;
+		joined.last = i;
+		joined.bounds.growToInclude(item.bounds);
+	}
+	sceneStats.batchesAfter = batches.size();
+
+	GLuint blendSrc = 0, blendDst = 0;
+	bool blendSet = false;
+	for (size_t b = 0; b < batches.size(); ++b) {
+		const ofxSkeletonDrawList::Item& first = items[batches[b].first];
+		if (!blendSet || first.blendSrc != blendSrc || first.blendDst != blendDst) {
+			batch->draw();
+			if (blendSet) OFX_SPINE_COUNT(&stats, blendSwitches, 1);
+			blendSrc = first.blendSrc;
+			blendDst = first.blendDst;
+			blendSet = true;
+			glBlendFunc(blendSrc, blendDst);
+		}
+		for (int i = batches[b].first; i >= 0; i = next[i]) {
+			const ofxSkeletonDrawList::Item& item = items[i];
+			batch->add(item.texture, &list.vertices[item.verticesOffset], item.uvs, item.verticesCount, item.triangles,
+				item.trianglesCount, item.color);
+		}
+	}
+	batch->draw();
+	if (debugOverlay && !debugOverlay->isEmpty()) debugOverlay->draw();
+	ofSetColor(255);
+}
@@ -0,0 +1,72 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+#include "ofxSkeletonRenderer.h"
+#include "ofxPolygonBatch.h"
+#include "ofxSpineStats.h"
+
+/** Draws many skeletons as one stream. Instances are ordered by (layer, depth), lowest first, and their attachments are merged
+  * into shared batches: an attachment moves back to join an earlier batch with the same texture and blend function only when
+  * it overlaps nothing drawn in between, so the result looks the same as drawing the skeletons one by one in that order. */
+class ofxSkeletonScene
+{
+public:
+
+	struct Stats
+	{
+		int instances;
+		int attachments;
+		int batchesBefore; // Texture or blend changes in draw order.
+		int batchesAfter; // After merging.
+	};
+
+	/* Merge attachments into earlier batches. Default true; false draws in strict order, still sharing one batch. */
+	bool reorder;
+	/* How many batches back an attachment may move. Default 16. */
+	int maxLookback;
+
+	/* Draw calls, vertices and submit time of the last draw(). */
+	ofxSpineStats stats;
+
+	/* Debug geometry of the instances with debugSlots or debugBones set, drawn on top of all instances. Each instance adds
+	 * what its own flags ask for, limited by the overlay's draw* flags. */
+	shared_ptr<ofxSkeletonDebugOverlay> debugOverlay;
+
+	static shared_ptr<ofxSkeletonScene> create ();
+
+	ofxSkeletonScene();
+
+	void add (shared_ptr<ofxSkeletonRenderer> instance, int layer = 0, float depth = 0);
+	void remove (shared_ptr<ofxSkeletonRenderer> instance);
+	void clear ();
+	void setSortKey (shared_ptr<ofxSkeletonRenderer> instance, int layer, float depth);
+
+	void draw ();
+
+	const Stats& getStats () const { return sceneStats; }
+
+private:
+	struct Entry
+	{
+		shared_ptr<ofxSkeletonRenderer> instance;
+		int layer;
+		float depth;
+		int order; // Keeps equal keys in insertion order.
+	};
+
+	struct Batch
+	{
+		int first; // Into batchItems, a linked list through next.
+		int last;
+		ofRectangle bounds;
+	};
+
+	vector<Entry> entries;
+	int orders;
+	ofxSkeletonDrawList list;
+	vector<Batch> batches;
+	vector<int> next;
+	shared_ptr<ofxPolygonBatch> batch;
+	Stats sceneStats;
+};
@@ -0,0 +1,239 @@
+#include "ofxSkeletonSpatialIndex.h"
+
+#include <spine/extension.h>
+
+/* Instances covering more cells than this go to the large list instead of the grid. */
+static const int MAX_CELLS = 64;
+
+shared_ptr<ofxSkeletonSpatialIndex> ofxSkeletonSpatialIndex::create (float cellSize) {
+	return make_shared<ofxSkeletonSpatialIndex>(cellSize);
+}
+
+ofxSkeletonSpatialIndex::ofxSkeletonSpatialIndex(float cellSize)
+	: boundsFallback(true), cellSize(cellSize), mark(0), orders(0), candidates(0) {
+}
+
+void ofxSkeletonSpatialIndex::add (shared_ptr<ofxSkeletonRenderer> instance) {
+	if (!instance) return;
+	Entry entry;
+	entry.instance = instance;
+	entry.bounds = instance->getCachedBounds();
+	entry.minX = entry.minY = 0;
+	entry.maxX = entry.maxY = -1;
+	entry.mark = 0;
+	entry.order = orders++;
+	entries.push_back(entry);
+	insert(entries.size() - 1);
+}
+
+void ofxSkeletonSpatialIndex::remove (shared_ptr<ofxSkeletonRenderer> instance) {
+	for (size_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].instance != instance) continue;
+		erase(i);
+		// Move the last entry into the hole and renumber it in its cells.
+		int last = entries.size() - 1;
+		if ((int)i != last) {
+			erase(last);
+			entries[i] = entries[last];
+			entries.pop_back();
+			insert(i);
+		} else {
+			entries.pop_back();
+		}
+		return;
+	}
+}
+
+void ofxSkeletonSpatialIndex::clear () {
+	entries.clear();
+	cells.clear();
+	large.clear();
+}
+
+void ofxSkeletonSpatialIndex::insert (int index) {
+	Entry& entry = entries[index];
+	entry.minX = toCell(entry.bounds.x);
+	entry.minY = toCell(entry.bounds.y);
+	entry.maxX = toCell(entry.bounds.x + entry.bounds.width);
+	entry.maxY = toCell(entry.bounds.y + entry.bounds.height);
+	if ((int64_t)(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) > MAX_CELLS) {
+		large.push_back(index);
+		return;
+	}
+	for (int y = entry.minY; y <= entry.maxY; ++y)
+		for (int x = entry.minX; x <= entry.maxX; ++x)
+			cells[cellKey(x, y)].push_back(index);
+}
+
+void ofxSkeletonSpatialIndex::erase (int index) {
+	Entry& entry = entries[index];
+	if (entry.maxX < entry.minX) return;
+	if ((int64_t)(entry.maxX - entry.minX + 1) * (entry.maxY - entry.minY + 1) > MAX_CELLS) {
+		large.erase(std::remove(large.begin(), large.end(), index), large.end());
+	} else {
+		for (int y = entry.minY; y <= entry.maxY; ++y) {
+			for (int x = entry.minX; x <= entry.maxX; ++x) {
+				auto cell = cells.find(cellKey(x, y));
+				if (cell == cells.end()) continue;
+				vector<int>& list = cell->second;
+				list.erase(std::remove(list.begin(), list.end(), index), list.end());
+				if (list.empty()) cells.erase(cell);
+			}
+		}
+	}
+	entry.minX = entry.minY = 0;
+	entry.maxX = entry.maxY = -1;
+}
+
+void ofxSkeletonSpatialIndex::update () {
+	for (size_t i = 0; i < entries.size(); ++i) {
+		Entry& entry = entries[i];
+		entry.bounds = entry.instance->getCachedBounds();
+		if (toCell(entry.bounds.x) == entry.minX && toCell(entry.bounds.y) == entry.minY
+			&& toCell(entry.bounds.x + entry.bounds.width) == entry.maxX && toCell(entry.bounds.y + entry.bounds.height) == entry.maxY)
+			continue;
+		erase(i);
+		insert(i);
+	}
+}
+
+template <typename Visit> void ofxSkeletonSpatialIndex::visit (const ofRectangle& rect, Visit visit) {
+	candidates = 0;
+	if (++mark == 0) {
+		// Wrapped: stale marks could match again.
+		for (size_t i = 0; i < entries.size(); ++i) entries[i].mark = 0;
+		mark = 1;
+	}
+	int minX = toCell(rect.x), minY = toCell(rect.y);
+	int maxX = toCell(rect.x + rect.width), maxY = toCell(rect.y + rect.height);
+	if ((int64_t)(maxX - minX + 1) * (maxY - minY + 1) > (int64_t)cells.size()) {
+		// Cheaper to walk the occupied cells than the rect.
+		for (auto& cell : cells) {
+			int x = (int32_t)((uint64_t)cell.first >> 32), y = (int32_t)(uint32_t)cell.first;
+			if (x < minX || x > maxX || y < minY || y > maxY) continue;
+			for (int index : cell.second) {
+				if (entries[index].mark == mark) continue;
+				entries[index].mark = mark;
+				candidates++;
+				visit(index);
+			}
+		}
+	} else {
+		for (int y = minY; y <= maxY; ++y) {
+			for (int x = minX; x <= maxX; ++x) {
+				auto cell = cells.find(cellKey(x, y));
+				if (cell == cells.end()) continue;
+				for (int index : cell->second) {
+					if (entries[index].mark == mark) continue;
+					entries[index].mark = mark;
+					candidates++;
+					visit(index);
+				}
+			}
+		}
+	}
+	for (int index : large) {
+		candidates++;
+		visit(index);
+	}
+}
+
+void ofxSkeletonSpatialIndex::queryPoint (float x, float y, vector<shared_ptr<ofxSkeletonRenderer> >& results) {
+	visit(ofRectangle(x, y, 0, 0), [&](int index) {
+		if (entries[index].bounds.inside(x, y)) results.push_back(entries[index].instance);
+	});
+}
+
+void ofxSkeletonSpatialIndex::queryRect (const ofRectangle& rect, vector<shared_ptr<ofxSkeletonRenderer> >& results) {
+	visit(rect, [&](int index) {
+		if (entries[index].bounds.intersects(rect)) results.push_back(entries[index].instance);
+	});
+}
+
+/* Even-odd rule, like spPolygon_containsPoint. */
+static bool polygonContains (const float* vertices, int verticesCount, float x, float y) {
+	bool inside = false;
+	for (int i = 0, prev = verticesCount - 2; i < verticesCount; prev = i, i += 2) {
+		float vy = vertices[i + 1], prevY = vertices[prev + 1];
+		if ((vy < y && prevY >= y) || (prevY < y && vy >= y)) {
+			float vx = vertices[i];
+			if (vx + (y - vy) / (prevY - vy) * (vertices[prev] - vx) < x) inside = !inside;
+		}
+	}
+	return inside;
+}
+
+bool ofxSkeletonSpatialIndex::containsPoint (ofxSkeletonRenderer& instance, float x, float y, vector<Hit>* hits) {
+	// Bring the point into skeleton coordinates instead of transforming every polygon.
+	float m[6];
+	instance.getTransform().getMatrix(m);
+	float det = m[0] * m[4] - m[1] * m[3];
+	if (det == 0) return false;
+	float dx = x - m[2], dy = y - m[5];
+	float localX = (m[4] * dx - m[1] * dy) / det, localY = (m[0] * dy - m[3] * dx) / det;
+
+	// Snapshot renderers are tested against the pose on screen, which the cached bounds came from, not the live skeleton.
+	bool found = false;
+	const spSkeleton* skeleton = instance.skeleton;
+	const ofxSkeletonPose* pose = instance.getDrawnSnapshot();
+	if (pose && (int)pose->slots.size() != skeleton->slotsCount) pose = 0;
+	for (int i = 0; i < skeleton->slotsCount; ++i) {
+		int slotIndex = pose ? pose->drawOrder[i] : 0;
+		spSlot* slot = pose ? skeleton->slots[slotIndex] : skeleton->drawOrder[i];
+		spAttachment* attachment = pose ? pose->slots[slotIndex].attachment : slot->attachment;
+		if (!attachment || attachment->type != SP_ATTACHMENT_BOUNDING_BOX) continue;
+		spBoundingBoxAttachment* box = (spBoundingBoxAttachment*)attachment;
+		if ((int)worldVertices.size() < box->verticesCount) worldVertices.resize(box->verticesCount);
+		if (pose) pose->computeWorldVertices(slotIndex, &worldVertices[0]);
+		else spBoundingBoxAttachment_computeWorldVertices(box, slot->bone, &worldVertices[0]);
+		if (!polygonContains(&worldVertices[0], box->verticesCount, localX, localY)) continue;
+		found = true;
+		if (!hits) return true;
+		Hit hit = { shared_ptr<ofxSkeletonRenderer>(), slot, box };
+		hits->push_back(hit);
+	}
+	return found;
+}
+
+/* True if the instance has no bounding box attachment to test, in the drawn snapshot if there is one. */
+static bool hasNoBoxes (const ofxSkeletonRenderer& instance) {
+	const ofxSkeletonPose* pose = instance.getDrawnSnapshot();
+	const spSkeleton* skeleton = instance.skeleton;
+	if (pose && (int)pose->slots.size() != skeleton->slotsCount) pose = 0;
+	for (int i = 0; i < skeleton->slotsCount; ++i) {
+		spAttachment* attachment = pose ? pose->slots[i].attachment : skeleton->slots[i]->attachment;
+		if (attachment && attachment->type == SP_ATTACHMENT_BOUNDING_BOX) return false;
+	}
+	return true;
+}
+
+void ofxSkeletonSpatialIndex::hitTest (float x, float y, vector<Hit>& hits) {
+	visit(ofRectangle(x, y, 0, 0), [&](int index) {
+		Entry& entry = entries[index];
+		if (!entry.bounds.inside(x, y)) return;
+		size_t first = hits.size();
+		if (containsPoint(*entry.instance, x, y, &hits)) {
+			for (size_t i = first; i < hits.size(); ++i) hits[i].instance = entry.instance;
+		} else if (boundsFallback && hasNoBoxes(*entry.instance)) {
+			Hit hit = { entry.instance, 0, 0 };
+			hits.push_back(hit);
+		}
+	});
+}
+
+shared_ptr<ofxSkeletonRenderer> ofxSkeletonSpatialIndex::pick (float x, float y, spSlot** slot) {
+	shared_ptr<ofxSkeletonRenderer> result;
+	int order = -1;
+	vector<Hit> hits;
+	visit(ofRectangle(x, y, 0, 0), [&](int index) {
+		Entry& entry = entries[index];
+		if (entry.order < order || !entry.bounds.inside(x, y)) return;
+		hits.clear();
+		bool hit = containsPoint(*entry.instance, x, y, &hits);
+		if (!hit && !(boundsFallback && hasNoBoxes(*entry.instance))) return;
+		result = entry.instance;
+		order = entry.order;
+		if (slot) *slot = hit ? hits.back().slot : 0; // Last in draw order is on top.
+	});
+	return result;
+}
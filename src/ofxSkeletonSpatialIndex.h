@@ -0,0 +1,86 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include "ofxSkeletonRenderer.h"
+
+/** Uniform grid over the cached bounds of many instances (ofxSkeletonRenderer::getCachedBounds), for picking and overlap
+  * tests without recomputing any vertices. Broad phase queries return the instances whose bounds touch a point or rect;
+  * hitTest() then tests the spBoundingBoxAttachment polygons of those instances.
+  *
+  * Call update() once per frame after drawing (or after boundingBox()), so the cells follow the instances. Only instances
+  * whose cell range changed are moved. Not thread-safe. */
+class ofxSkeletonSpatialIndex
+{
+public:
+
+	struct Hit
+	{
+		shared_ptr<ofxSkeletonRenderer> instance;
+		spSlot* slot; // 0 for instances hit by their bounds, see boundsFallback.
+		spBoundingBoxAttachment* attachment;
+	};
+
+	/* Instances without any bounding box attachment are hit by their cached bounds. Default true. */
+	bool boundsFallback;
+
+	static shared_ptr<ofxSkeletonSpatialIndex> create (float cellSize = 256);
+
+	/* @param cellSize Roughly the size of an instance on screen. */
+	ofxSkeletonSpatialIndex(float cellSize = 256);
+
+	void add (shared_ptr<ofxSkeletonRenderer> instance);
+	void remove (shared_ptr<ofxSkeletonRenderer> instance);
+	void clear ();
+
+	/* Re-reads the cached bounds of every instance. */
+	void update ();
+
+	// --- Broad phase. Results are appended, in no particular order.
+	void queryPoint (float x, float y, vector<shared_ptr<ofxSkeletonRenderer> >& results);
+	void queryRect (const ofRectangle& rect, vector<shared_ptr<ofxSkeletonRenderer> >& results);
+
+	// --- Narrow phase. Appends one hit per bounding box polygon containing the point.
+	void hitTest (float x, float y, vector<Hit>& hits);
+	/* Returns the most recently added instance containing the point, or 0. */
+	shared_ptr<ofxSkeletonRenderer> pick (float x, float y, spSlot** slot = 0);
+
+	/* Tests the instance's bounding box attachments, as posed in the drawn snapshot for snapshot renderers. Returns false if
+	 * it has none. */
+	bool containsPoint (ofxSkeletonRenderer& instance, float x, float y, vector<Hit>* hits = 0);
+
+	int getInstancesCount () const { return entries.size(); }
+	int getCellsCount () const { return cells.size(); }
+	/* Instances whose bounds were tested by the last query. */
+	int getCandidatesCount () const { return candidates; }
+
+	float getCellSize () const { return cellSize; }
+
+private:
+	struct Entry
+	{
+		shared_ptr<ofxSkeletonRenderer> instance;
+		ofRectangle bounds;
+		int minX, minY, maxX, maxY; // Cell range; maxX < minX when not in the grid.
+		unsigned int mark;
+		int order; // Insertion order, for pick().
+	};
+
+	static int64_t cellKey (int x, int y) { return (int64_t)((uint64_t)(uint32_t)x << 32 | (uint32_t)y); }
+	int toCell (float v) const { return (int)floorf(v / cellSize); }
+
+	void insert (int index);
+	void erase (int index);
+	/* Calls visit(entry index) once per instance in the cells touching the rect. */
+	template <typename Visit> void visit (const ofRectangle& rect, Visit visit);
+
+	float cellSize;
+	vector<Entry> entries;
+	unordered_map<int64_t, vector<int> > cells;
+	vector<int> large; // Instances spanning too many cells to insert, tested on every query.
+	unsigned int mark;
+	int orders;
+	int candidates;
+	vector<float> worldVertices;
+};
@@ -0,0 +1,60 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+
+/** Per-instance model transform, applied to the world vertices when they are written to the batch instead of moving the
+  * skeleton's root. Rotation is in degrees; flips mirror around the instance origin. */
+struct ofxSkeletonTransform
+{
+	float x, y;
+	float rotation;
+	float scaleX, scaleY;
+	bool flipX, flipY;
+
+	ofxSkeletonTransform()
+		: x(0), y(0), rotation(0), scaleX(1), scaleY(1), flipX(false), flipY(false) {
+	}
+
+	bool isIdentity () const {
+		return x == 0 && y == 0 && rotation == 0 && scaleX == 1 && scaleY == 1 && !flipX && !flipY;
+	}
+
+	/* Affine matrix { a, b, tx, c, d, ty }: x' = a * x + b * y + tx, y' = c * x + d * y + ty. */
+	void getMatrix (float* m) const {
+		float radians = ofDegToRad(rotation);
+		float cos = cosf(radians), sin = sinf(radians);
+		float sx = flipX ? -scaleX : scaleX, sy = flipY ? -scaleY : scaleY;
+		m[0] = cos * sx;
+		m[1] = -sin * sy;
+		m[2] = x;
+		m[3] = sin * sx;
+		m[4] = cos * sy;
+		m[5] = y;
+	}
+
+	ofMatrix4x4 getMatrix4x4 () const {
+		float m[6];
+		getMatrix(m);
+		return ofMatrix4x4(
+			m[0], m[3], 0, 0,
+			m[1], m[4], 0, 0,
+			0, 0, 1, 0,
+			m[2], m[5], 0, 1);
+	}
+
+	ofVec2f apply (const ofVec2f& point) const {
+		float m[6];
+		getMatrix(m);
+		return ofVec2f(m[0] * point.x + m[1] * point.y + m[2], m[3] * point.x + m[4] * point.y + m[5]);
+	}
+
+	/* Transforms count / 2 interleaved x, y pairs in place. */
+	static void apply (const float* m, float* vertices, int count) {
+		for (int i = 0; i < count; i += 2) {
+			float vx = vertices[i], vy = vertices[i + 1];
+			vertices[i] = m[0] * vx + m[1] * vy + m[2];
+			vertices[i + 1] = m[3] * vx + m[4] * vy + m[5];
+		}
+	}
+};
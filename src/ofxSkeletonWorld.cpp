@@ -0,0 +1,158 @@
+#include "ofxSkeletonWorld.h"
+
+shared_ptr<ofxSkeletonWorld> ofxSkeletonWorld::create (float stepsPerSecond) {
+	return make_shared<ofxSkeletonWorld>(stepsPerSecond);
+}
+
+ofxSkeletonWorld::ofxSkeletonWorld(float stepsPerSecond)
+	: maxStepsPerFrame(0), maxStepsPerInstance(4), maxLag(0.25f), interpolate(true), stepTime(1 / 60.0f), cursor(0) {
+	setStepsPerSecond(stepsPerSecond);
+	memset(&stats, 0, sizeof(stats));
+}
+
+void ofxSkeletonWorld::setStepsPerSecond (float stepsPerSecond) {
+	if (stepsPerSecond <= 0) {
+		ofLogError("ofxSkeletonWorld") << "steps per second must be positive: " << stepsPerSecond;
+		return;
+	}
+	stepTime = 1 / stepsPerSecond;
+}
+
+int ofxSkeletonWorld::find (shared_ptr<ofxSkeletonRenderer> instance) const {
+	for (size_t i = 0; i < instances.size(); ++i)
+		if (instances[i].renderer == instance) return i;
+	return -1;
+}
+
+void ofxSkeletonWorld::add (shared_ptr<ofxSkeletonRenderer> instance) {
+	if (!instance || find(instance) >= 0) return;
+	instances.push_back(Instance());
+	Instance& added = instances.back();
+	added.renderer = instance;
+	added.accumulator = 0;
+	added.steps = 0;
+	added.poses = 0;
+}
+
+void ofxSkeletonWorld::remove (shared_ptr<ofxSkeletonRenderer> instance) {
+	int index = find(instance);
+	if (index < 0) return;
+	instances.erase(instances.begin() + index);
+	if (cursor > index) cursor--;
+	if (cursor >= (int)instances.size()) cursor = 0;
+}
+
+void ofxSkeletonWorld::clear () {
+	instances.clear();
+	cursor = 0;
+}
+
+void ofxSkeletonWorld::update (float deltaTime) {
+	int count = instances.size();
+	stats.instances = count;
+	stats.steps = 0;
+	stats.deferredSteps = 0;
+	if (!count) return;
+
+	if (deltaTime < 0) deltaTime = 0;
+	for (int i = 0; i < count; ++i) {
+		Instance& instance = instances[i];
+		instance.accumulator += deltaTime;
+		if (instance.accumulator > maxLag + stepTime) {
+			stats.droppedTime += instance.accumulator - (maxLag + stepTime);
+			instance.accumulator = maxLag + stepTime;
+		}
+		instance.steps = 0;
+	}
+
+	// Plan in rounds of one step per instance from the cursor, so with a tight budget every instance gets its first step
+	// before any gets a second, and the instances left out this frame go first in the next.
+	int budget = maxStepsPerFrame > 0 ? maxStepsPerFrame : count * max(1, maxStepsPerInstance);
+	int perInstance = max(1, maxStepsPerInstance);
+	for (int round = 0; round < perInstance && budget > 0; ++round) {
+		bool planned = false;
+		for (int n = 0; n < count && budget > 0; ++n) {
+			Instance& instance = instances[(cursor + n) % count];
+			if (instance.accumulator < (instance.steps + 1) * (double)stepTime) continue;
+			instance.steps++;
+			budget--;
+			planned = true;
+		}
+		if (!planned) break;
+	}
+	int next = (cursor + 1) % count;
+	for (int n = 0; n < count; ++n) {
+		int i = (cursor + n) % count;
+		const Instance& instance = instances[i];
+		if (instance.steps < perInstance && instance.accumulator >= (instance.steps + 1) * (double)stepTime) {
+			next = i;
+			break;
+		}
+	}
+	cursor = next;
+
+	uint64_t start = ofGetElapsedTimeMicros();
+	for (int i = 0; i < count; ++i) {
+		Instance& instance = instances[i];
+		for (int s = 0; s < instance.steps; ++s) {
+			// Only the last step of the frame is interpolated from, so only its start and end are captured.
+			if (s == instance.steps - 1 && interpolate) {
+				instance.previous.capture(instance.renderer->skeleton);
+				instance.previous.time = instance.renderer->skeleton->time;
+			}
+			instance.renderer->update(stepTime);
+			instance.accumulator -= stepTime;
+		}
+		if (instance.steps) {
+			if (interpolate) {
+				instance.current.capture(instance.renderer->skeleton);
+				instance.current.time = instance.renderer->skeleton->time;
+				instance.poses = 2;
+			}
+			stats.steps += instance.steps;
+		}
+		if (!interpolate) instance.poses = 0;
+		stats.deferredSteps += (int)(instance.accumulator / stepTime);
+	}
+	stats.stepMillis = (ofGetElapsedTimeMicros() - start) / 1000.0;
+	stats.maxSteps = max(stats.maxSteps, stats.steps);
+}
+
+void ofxSkeletonWorld::resetStats () {
+	stats.maxSteps = 0;
+	stats.droppedTime = 0;
+}
+
+float ofxSkeletonWorld::getAlpha (shared_ptr<ofxSkeletonRenderer> instance) const {
+	int index = find(instance);
+	if (index < 0) return 1;
+	return ofClamp(instances[index].accumulator / stepTime, 0, 1);
+}
+
+void ofxSkeletonWorld::draw () {
+	for (size_t i = 0; i < instances.size(); ++i) draw(instances[i]);
+}
+
+void ofxSkeletonWorld::draw (shared_ptr<ofxSkeletonRenderer> instance) {
+	int index = find(instance);
+	if (index >= 0) draw(instances[index]);
+}
+
+bool ofxSkeletonWorld::getInterpolatedPose (shared_ptr<ofxSkeletonRenderer> instance, ofxSkeletonPose& pose) const {
+	int index = find(instance);
+	return index >= 0 && getInterpolatedPose(instances[index], pose);
+}
+
+bool ofxSkeletonWorld::getInterpolatedPose (const Instance& instance, ofxSkeletonPose& pose) const {
+	if (!interpolate || instance.poses < 2) return false;
+	pose.interpolate(instance.previous, instance.current, ofClamp(instance.accumulator / stepTime, 0, 1));
+	return true;
+}
+
+void ofxSkeletonWorld::draw (Instance& instance) {
+	if (!getInterpolatedPose(instance, interpolated)) {
+		instance.renderer->draw();
+		return;
+	}
+	instance.renderer->drawPose(interpolated);
+}
@@ -0,0 +1,88 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include "ofxSkeletonRenderer.h"
+#include "ofxSkeletonPose.h"
+
+/** Updates many skeletons at a fixed rate instead of once per frame with the frame time. Each instance accumulates frame time
+  * and runs whole steps of getStepTime() seconds, so events fire at the same times whatever the frame rate, and a fast display
+  * does no more animation work than a slow one. draw() interpolates between the last two steps by the time left over.
+  *
+  * After a hitch the owed steps are not all run at once: a frame runs at most maxStepsPerFrame steps in total and
+  * maxStepsPerInstance per instance, starting each frame where the previous one ran out of budget, so catching up is spread
+  * over frames and instances. Time owed beyond maxLag is dropped. */
+class ofxSkeletonWorld
+{
+public:
+
+	struct Stats
+	{
+		int instances;
+		int steps;         // Steps run by the last update().
+		int deferredSteps; // Steps owed after the last update().
+		int maxSteps;      // Most steps run by one update() since creation or resetStats().
+		double droppedTime; // Seconds dropped by maxLag since creation or resetStats().
+		double stepMillis; // Time spent stepping in the last update().
+	};
+
+	/* Per frame. Default 0, no limit. */
+	int maxStepsPerFrame;
+	/* Default 4. */
+	int maxStepsPerInstance;
+	/* Seconds. Default 0.25. */
+	float maxLag;
+	/* Draw the pose between the last two steps. Default true; false draws the last step. */
+	bool interpolate;
+
+	static shared_ptr<ofxSkeletonWorld> create (float stepsPerSecond = 60);
+
+	ofxSkeletonWorld(float stepsPerSecond = 60);
+
+	void add (shared_ptr<ofxSkeletonRenderer> instance);
+	void remove (shared_ptr<ofxSkeletonRenderer> instance);
+	void clear ();
+
+	void setStepsPerSecond (float stepsPerSecond);
+	float getStepTime () const { return stepTime; }
+
+	/* Adds deltaTime to every instance and runs the steps that are due and fit in the budget. */
+	void update (float deltaTime);
+	/* Draws every instance in the order they were added. */
+	void draw ();
+	void draw (shared_ptr<ofxSkeletonRenderer> instance);
+
+	/* Fraction of a step the instance's drawn pose is behind its simulation, 0 to 1. */
+	float getAlpha (shared_ptr<ofxSkeletonRenderer> instance) const;
+
+	/* The pose draw() draws for the instance. Returns false if it draws the live skeleton instead: the instance was not
+	 * found, has not stepped yet or interpolate is off. */
+	bool getInterpolatedPose (shared_ptr<ofxSkeletonRenderer> instance, ofxSkeletonPose& pose) const;
+
+	int getInstancesCount () const { return instances.size(); }
+	const Stats& getStats () const { return stats; }
+	/* Clears maxSteps and droppedTime. */
+	void resetStats ();
+
+private:
+	struct Instance
+	{
+		shared_ptr<ofxSkeletonRenderer> renderer;
+		double accumulator;
+		int steps; // Planned for this update.
+		int poses; // 2 once previous and current hold the start and end of a step.
+		ofxSkeletonPose previous;
+		ofxSkeletonPose current;
+	};
+
+	int find (shared_ptr<ofxSkeletonRenderer> instance) const;
+	void draw (Instance& instance);
+	bool getInterpolatedPose (const Instance& instance, ofxSkeletonPose& pose) const;
+
+	float stepTime;
+	vector<Instance> instances;
+	int cursor; // First instance offered a step next update.
+	ofxSkeletonPose interpolated;
+	Stats stats;
+};
@@ -0,0 +1,113 @@
+#include "ofxSkeletonWorldExport.h"
+
+shared_ptr<ofxSkeletonWorldExport> ofxSkeletonWorldExport::create (spSkeletonData* skeletonData, const vector<string>& boneNames,
+	const vector<string>& slotNames)
+{
+	return make_shared<ofxSkeletonWorldExport>(skeletonData, boneNames, slotNames);
+}
+
+ofxSkeletonWorldExport::ofxSkeletonWorldExport(spSkeletonData* skeletonData, const vector<string>& boneNames,
+	const vector<string>& slotNames)
+	: skeletonData(skeletonData)
+{
+	for (size_t i = 0; i < boneNames.size(); ++i) {
+		int index = spSkeletonData_findBoneIndex(skeletonData, boneNames[i].c_str());
+		if (index < 0) ofLogWarning("ofxSkeletonWorldExport") << "Bone not found: " << boneNames[i];
+		boneIndices.push_back(index);
+	}
+	for (size_t i = 0; i < slotNames.size(); ++i) {
+		int index = spSkeletonData_findSlotIndex(skeletonData, slotNames[i].c_str());
+		int boneIndex = -1;
+		if (index < 0) {
+			ofLogWarning("ofxSkeletonWorldExport") << "Slot not found: " << slotNames[i];
+		} else {
+			for (int ii = 0; ii < skeletonData->bonesCount; ++ii) {
+				if (skeletonData->bones[ii] == skeletonData->slots[index]->boneData) {
+					boneIndex = ii;
+					break;
+				}
+			}
+		}
+		slotIndices.push_back(index);
+		slotBoneIndices.push_back(boneIndex);
+	}
+}
+
+bool ofxSkeletonWorldExport::add (shared_ptr<ofxSkeletonRenderer> instance) {
+	if (!instance || instance->skeleton->data != skeletonData) return false;
+	instances.push_back(instance);
+	resize();
+	return true;
+}
+
+void ofxSkeletonWorldExport::remove (shared_ptr<ofxSkeletonRenderer> instance) {
+	instances.erase(std::remove(instances.begin(), instances.end(), instance), instances.end());
+	resize();
+}
+
+void ofxSkeletonWorldExport::clear () {
+	instances.clear();
+	resize();
+}
+
+void ofxSkeletonWorldExport::resize () {
+	size_t bones = instances.size() * boneIndices.size();
+	boneX.resize(bones);
+	boneY.resize(bones);
+	boneRotation.resize(bones);
+	boneScaleX.resize(bones);
+	boneScaleY.resize(bones);
+
+	size_t slots = instances.size() * slotIndices.size();
+	slotX.resize(slots);
+	slotY.resize(slots);
+	slotRotation.resize(slots);
+	slotR.resize(slots);
+	slotG.resize(slots);
+	slotB.resize(slots);
+	slotA.resize(slots);
+	slotAttachment.resize(slots);
+}
+
+/* World position, rotation and scale of a bone, in the instance's coordinates. */
+static void boneWorld (const spBone* bone, const spSkeleton* skeleton, const float* m,
+	float& x, float& y, float& rotation, float& scaleX, float& scaleY)
+{
+	float wx = skeleton->x + bone->worldX, wy = skeleton->y + bone->worldY;
+	x = m[0] * wx + m[1] * wy + m[2];
+	y = m[3] * wx + m[4] * wy + m[5];
+	float a = m[0] * bone->a + m[1] * bone->c, b = m[0] * bone->b + m[1] * bone->d;
+	float c = m[3] * bone->a + m[4] * bone->c, d = m[3] * bone->b + m[4] * bone->d;
+	rotation = ofRadToDeg(atan2f(c, a));
+	scaleX = sqrtf(a * a + c * c);
+	scaleY = sqrtf(b * b + d * d);
+	if (a * d - b * c < 0) scaleY = -scaleY;
+}
+
+void ofxSkeletonWorldExport::update () {
+	int bonesCount = boneIndices.size(), slotsCount = slotIndices.size();
+	float m[6];
+	for (size_t i = 0; i < instances.size(); ++i) {
+		const spSkeleton* skeleton = instances[i]->skeleton;
+		instances[i]->getTransform().getMatrix(m);
+
+		for (int ii = 0, o = i * bonesCount; ii < bonesCount; ++ii, ++o) {
+			int index = boneIndices[ii];
+			if (index < 0) continue;
+			boneWorld(skeleton->bones[index], skeleton, m, boneX[o], boneY[o], boneRotation[o], boneScaleX[o], boneScaleY[o]);
+		}
+
+		float scaleX, scaleY;
+		for (int ii = 0, o = i * slotsCount; ii < slotsCount; ++ii, ++o) {
+			int index = slotIndices[ii];
+			if (index < 0) continue;
+			const spSlot* slot = skeleton->slots[index];
+			boneWorld(skeleton->bones[slotBoneIndices[ii]], skeleton, m, slotX[o], slotY[o], slotRotation[o], scaleX, scaleY);
+			slotR[o] = slot->r;
+			slotG[o] = slot->g;
+			slotB[o] = slot->b;
+			slotA[o] = slot->a;
+			slotAttachment[o] = slot->attachment;
+		}
+	}
+}
@@ -0,0 +1,51 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include "ofxSkeletonRenderer.h"
+
+/** Copies the world state of a fixed set of bones and slots of many instances of one SkeletonData into contiguous
+  * structure-of-arrays buffers, for physics, particles and hit reactions. Names are resolved once; after updating the
+  * instances, update() refills every array. Element [instance * getBonesCount() + bone] (or slot) belongs to the instance
+  * added at that position. Positions and rotations include the skeleton position and the instance transform. */
+class ofxSkeletonWorldExport
+{
+public:
+	static shared_ptr<ofxSkeletonWorldExport> create (spSkeletonData* skeletonData, const vector<string>& boneNames,
+		const vector<string>& slotNames = vector<string>());
+
+	ofxSkeletonWorldExport(spSkeletonData* skeletonData, const vector<string>& boneNames,
+		const vector<string>& slotNames = vector<string>());
+
+	/* Returns false if the instance does not use this export's SkeletonData. */
+	bool add (shared_ptr<ofxSkeletonRenderer> instance);
+	void remove (shared_ptr<ofxSkeletonRenderer> instance);
+	void clear ();
+
+	void update ();
+
+	int getInstancesCount () const { return instances.size(); }
+	int getBonesCount () const { return boneIndices.size(); }
+	int getSlotsCount () const { return slotIndices.size(); }
+
+	// --- Bones, [instance * getBonesCount() + bone]. Rotation in degrees.
+	vector<float> boneX, boneY;
+	vector<float> boneRotation;
+	vector<float> boneScaleX, boneScaleY;
+
+	// --- Slots, [instance * getSlotsCount() + slot]. Transform of the slot's bone.
+	vector<float> slotX, slotY;
+	vector<float> slotRotation;
+	vector<float> slotR, slotG, slotB, slotA;
+	vector<spAttachment*> slotAttachment;
+
+private:
+	void resize ();
+
+	spSkeletonData* skeletonData;
+	vector<int> boneIndices;
+	vector<int> slotIndices;
+	vector<int> slotBoneIndices;
+	vector<shared_ptr<ofxSkeletonRenderer> > instances;
+};
@@ -3,35 +3,51 @@
 #include <spine/extension.h>
 #include "ofMain.h"
 
+static bool loadTextures = true;
+
+void ofxSpineSetLoadTextures (bool value) {
+	loadTextures = value;
+}
+
+bool ofxSpineGetLoadTextures () {
+	return loadTextures;
+}
+
 void _spAtlasPage_createTexture(spAtlasPage* self, const char* path) {
-	
-	ofTexture * texture = new ofTexture();
 
-	// load image
-	ofImage loader;
-	loader.setUseTexture(false);
-	loader.loadImage(path);
+	// load image, or a compressed container next to it
+	if (loadTextures) ofxSpineTextureLoader::detectFormats();
+	ofxSpineTextureLoader::Image image;
+	if (!ofxSpineTextureLoader::load(path, image, loadTextures)) ofLogError("ofxSpineC") << "Error loading atlas page " << path;
 
 	// store width & height
-	int imageWidth = loader.getWidth();
-	int imageHeight = loader.getHeight();
+	self->width = image.width;
+	self->height = image.height;
 
-	// allocate texture & copy in data
-	texture->allocate(imageWidth, imageHeight, GL_RGBA);
-	texture->loadData(loader.getPixels(), imageWidth, imageHeight, GL_RGBA);
+	if (!loadTextures) {
+		self->rendererObject = 0;
+		return;
+	}
 
-	// clear temp image
-	loader.clear();
+	ofxSpinePageTexture * texture = new ofxSpinePageTexture();
+	ofxSpineTextureLoader::upload(image, *texture);
+	self->rendererObject = (ofTexture *)texture;
 
-	self->rendererObject = texture;
-	self->width = imageWidth;
-	self->height = imageHeight;
+	// the page stays with this manager, whatever is installed later
+	texture->residency = ofxSpineGetTextureResidency();
+	if (texture->residency) texture->residency->add(self, path, image.getBytes());
 }
 
 void _spAtlasPage_disposeTexture(spAtlasPage* self) {
-	delete (ofTexture *)self->rendererObject;
+	if (!self->rendererObject) return;
+	ofxSpinePageTexture * texture = ofxSpinePageTexture::get(self);
+	if (texture->residency) texture->residency->remove(self);
+	ofxSpineTextureLoader::clear(*texture);
+	delete texture;
 }
 
 char* _spUtil_readFile(const char* path, int* length) {
+	shared_ptr<ofxSpineFileSource> source = ofxSpineGetFileSource();
+	if (source) return source->readCopy(path, length);
 	return _readFile(ofToDataPath(path).c_str(), length);
 }
\ No newline at end of file
@@ -5,5 +5,19 @@
 #include <spine/spine.h>
 #include "ofxSkeletonRenderer.h"
 #include "ofxSkeletonAnimation.h"
+#include "ofxSpineStats.h"
+#include "ofxSkeletonSpatialIndex.h"
+#include "ofxSkeletonLazyData.h"
+#include "ofxSkeletonCompression.h"
+#include "ofxSpineTextureResidency.h"
+#include "ofxSpineTextureLoader.h"
+#include "ofxSkeletonScene.h"
+#include "ofxSkeletonWorld.h"
+#include "ofxSkeletonParallelJson.h"
+#include "ofxSpineFileSource.h"
+#include "ofxSkeletonMeshExport.h"
 
-
+/* When false, atlas pages are decoded only to read their size and no GL texture is created, so skeletons can be loaded
+ * and updated without a GL context. Attachments on such pages are skipped by draw(). Default true. */
+void ofxSpineSetLoadTextures (bool loadTextures);
+bool ofxSpineGetLoadTextures ();
@@ -0,0 +1,202 @@
+#include "ofxSpineFileSource.h"
+
+#include <spine/extension.h>
+#include <sys/stat.h>
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+class MemoryFile : public ofxSpineFile
+{
+public:
+	ofBuffer buffer;
+
+	const char* getData () const { return buffer.getData(); }
+	size_t getSize () const { return buffer.size(); }
+};
+
+class MappedFile : public ofxSpineFile
+{
+public:
+	const char* data;
+	size_t size;
+#ifdef TARGET_WIN32
+	HANDLE file, mapping;
+#endif
+
+	~MappedFile() {
+#ifdef TARGET_WIN32
+		UnmapViewOfFile(data);
+		CloseHandle(mapping);
+		CloseHandle(file);
+#else
+		munmap((void*)data, size);
+#endif
+	}
+
+	const char* getData () const { return data; }
+	size_t getSize () const { return size; }
+};
+
+shared_ptr<ofxSpineFile> readFile (const string& path) {
+	auto file = make_shared<MemoryFile>();
+	if (!ofFile::doesFileExist(path, false)) return nullptr;
+	file->buffer = ofBufferFromFile(path, true);
+	return file;
+}
+
+/* Returns 0 if the file cannot be mapped, eg. because it is empty. */
+shared_ptr<ofxSpineFile> mapFile (const string& path, size_t size) {
+	if (!size) return nullptr;
+#ifdef TARGET_WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE) return nullptr;
+	HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+	const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+	if (!data) {
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		return nullptr;
+	}
+	auto mapped = make_shared<MappedFile>();
+	mapped->file = file;
+	mapped->mapping = mapping;
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) return nullptr;
+	void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (data == MAP_FAILED) return nullptr;
+	auto mapped = make_shared<MappedFile>();
+#endif
+	mapped->data = (const char*)data;
+	mapped->size = size;
+	return mapped;
+}
+
+shared_ptr<ofxSpineFileSource> fileSource = make_shared<ofxSpineMappedFileSource>();
+
+}
+
+void ofxSpineSetFileSource (shared_ptr<ofxSpineFileSource> source) {
+	std::atomic_store(&fileSource, source);
+}
+
+shared_ptr<ofxSpineFileSource> ofxSpineGetFileSource () {
+	return std::atomic_load(&fileSource);
+}
+
+shared_ptr<ofxSpineFile> ofxSpineOpenFile (const string& path) {
+	shared_ptr<ofxSpineFileSource> source = ofxSpineGetFileSource();
+	if (source) return source->open(path);
+	return readFile(ofToDataPath(path));
+}
+
+ofxSpineFileSource::ofxSpineFileSource() {
+	resetStats();
+}
+
+char* ofxSpineFileSource::readCopy (const string& path, int* length) {
+	shared_ptr<ofxSpineFile> file = open(path);
+	if (!file) return 0;
+	uint64_t start = ofGetElapsedTimeMicros();
+	size_t size = file->getSize();
+	char* data = MALLOC(char, size + 1);
+	memcpy(data, file->getData(), size);
+	data[size] = 0;
+	*length = size;
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.copiedBytes += size;
+	stats.copyMillis += (ofGetElapsedTimeMicros() - start) / 1000.0;
+	return data;
+}
+
+void ofxSpineFileSource::count (bool opened, bool shared, size_t mappedBytes, size_t readBytes, double millis) {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.opens++;
+	if (!opened) stats.failures++;
+	if (shared) stats.shared++;
+	stats.mappedBytes += mappedBytes;
+	stats.readBytes += readBytes;
+	stats.openMillis += millis;
+}
+
+ofxSpineFileSource::Stats ofxSpineFileSource::getStats () const {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+void ofxSpineFileSource::resetStats () {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	memset(&stats, 0, sizeof(stats));
+}
+
+shared_ptr<ofxSpineMappedFileSource> ofxSpineMappedFileSource::create () {
+	return make_shared<ofxSpineMappedFileSource>();
+}
+
+ofxSpineMappedFileSource::ofxSpineMappedFileSource() {
+}
+
+shared_ptr<ofxSpineFile> ofxSpineMappedFileSource::open (const string& path) {
+	uint64_t start = ofGetElapsedTimeMicros();
+	string dataPath = ofToDataPath(path);
+	struct stat info;
+	if (stat(dataPath.c_str(), &info) != 0) {
+		count(false, false, 0, 0, (ofGetElapsedTimeMicros() - start) / 1000.0);
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto found = files.find(dataPath);
+	if (found != files.end() && found->second.size == (size_t)info.st_size && found->second.modified == info.st_mtime) {
+		shared_ptr<ofxSpineFile> file = found->second.file.lock();
+		if (file) {
+			count(true, true, 0, 0, (ofGetElapsedTimeMicros() - start) / 1000.0);
+			return file;
+		}
+	}
+
+	Entry entry;
+	entry.size = info.st_size;
+	entry.modified = info.st_mtime;
+	shared_ptr<ofxSpineFile> file = mapFile(dataPath, entry.size);
+	bool mapped = file != nullptr;
+	if (!mapped) file = readFile(dataPath);
+	if (!file) {
+		if (found != files.end()) files.erase(found);
+		count(false, false, 0, 0, (ofGetElapsedTimeMicros() - start) / 1000.0);
+		return nullptr;
+	}
+	// Only mappings are shared, and only while someone holds them.
+	entry.file = file;
+	if (mapped) files[dataPath] = entry;
+	else if (found != files.end()) files.erase(found);
+	size_t size = file->getSize();
+	count(true, false, mapped ? size : 0, mapped ? 0 : size, (ofGetElapsedTimeMicros() - start) / 1000.0);
+	return file;
+}
+
+void ofxSpineMappedFileSource::release (const string& path) {
+	std::lock_guard<std::mutex> lock(mutex);
+	files.erase(ofToDataPath(path));
+}
+
+void ofxSpineMappedFileSource::clear () {
+	std::lock_guard<std::mutex> lock(mutex);
+	files.clear();
+}
+
+int ofxSpineMappedFileSource::getFilesCount () const {
+	std::lock_guard<std::mutex> lock(mutex);
+	int count = 0;
+	for (auto& item : files)
+		if (!item.second.file.expired()) count++;
+	return count;
+}
@@ -0,0 +1,97 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+#include <mutex>
+
+/** Read-only contents of a source file. Not null terminated. */
+class ofxSpineFile
+{
+public:
+	virtual ~ofxSpineFile() {}
+
+	virtual const char* getData () const = 0;
+	virtual size_t getSize () const = 0;
+};
+
+/** Where skeleton, atlas and atlas page files are read from. Every spine-c file read (_spUtil_readFile) and page texture load
+  * goes through the installed source, as do ofxSkeletonLazyData and ofxSkeletonParallelJson, which use the contents in
+  * place. Subclass and override open() to read from an archive. open() may be called from several threads at once. */
+class ofxSpineFileSource
+{
+public:
+
+	struct Stats
+	{
+		int opens;
+		int shared; // Opens served by a file that was already open.
+		int failures;
+		size_t mappedBytes; // Made available without reading, by mapping.
+		size_t readBytes; // Read into memory.
+		size_t copiedBytes; // Copied into buffers spine-c owns.
+		double openMillis;
+		double copyMillis;
+	};
+
+	virtual ~ofxSpineFileSource() {}
+
+	/* Returns 0 if the file does not exist. path is as given to spine-c, relative to the data folder. */
+	virtual shared_ptr<ofxSpineFile> open (const string& path) = 0;
+
+	/* The file as a null terminated buffer allocated with MALLOC, for spine-c to FREE. Returns 0 if the file does not exist. */
+	char* readCopy (const string& path, int* length);
+
+	Stats getStats () const;
+	void resetStats ();
+
+protected:
+	ofxSpineFileSource();
+
+	/* For open() implementations. */
+	void count (bool opened, bool shared, size_t mappedBytes, size_t readBytes, double millis);
+
+private:
+	mutable std::mutex statsMutex;
+	Stats stats;
+};
+
+/** Maps files from the data folder read-only instead of reading them. While a mapping is held by a caller it is shared by
+  * every other open() of the same path, unless the file changed on disk, so loading the same skeleton twice at once neither
+  * reads nor allocates. The source only keeps weak references: a file is unmapped once the last caller drops it, so files
+  * replaced on disk are not held mapped. Falls back to reading when a file cannot be mapped; read files are not shared. */
+class ofxSpineMappedFileSource : public ofxSpineFileSource
+{
+public:
+	static shared_ptr<ofxSpineMappedFileSource> create ();
+
+	ofxSpineMappedFileSource();
+
+	shared_ptr<ofxSpineFile> open (const string& path);
+
+	/* Stops sharing the mapping with later opens; files still held by callers stay valid. */
+	void release (const string& path);
+	void clear ();
+
+	/* Mappings still held by callers. */
+	int getFilesCount () const;
+
+private:
+	struct Entry
+	{
+		weak_ptr<ofxSpineFile> file;
+		size_t size;
+		time_t modified;
+	};
+
+	mutable std::mutex mutex;
+	unordered_map<string, Entry> files;
+};
+
+/* Installs the source of skeleton, atlas and atlas page files. Default ofxSpineMappedFileSource; 0 reads every file from the
+ * data folder into memory like spine-c does. May be called while other threads load. */
+void ofxSpineSetFileSource (shared_ptr<ofxSpineFileSource> source);
+shared_ptr<ofxSpineFileSource> ofxSpineGetFileSource ();
+
+/* Opens a file through the installed source, or reads it from the data folder if there is none. Returns 0 if it does not
+ * exist. */
+shared_ptr<ofxSpineFile> ofxSpineOpenFile (const string& path);
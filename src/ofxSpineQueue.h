@@ -0,0 +1,85 @@
+//- GeistYp
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+/** Bounded lock-free queue for many producers and one or more consumers (Vyukov's sequence-numbered ring). push() and pop()
+  * never block or allocate; push() returns false when the queue is full. Items from one producer are popped in the order they
+  * were pushed. */
+template<class T>
+class ofxSpineQueue
+{
+public:
+	/* capacity is rounded up to a power of two. */
+	explicit ofxSpineQueue(size_t capacity = 256) {
+		size_t size = 2;
+		while (size < capacity) size <<= 1;
+		mask = size - 1;
+		cells.reset(new Cell[size]);
+		for (size_t i = 0; i < size; ++i)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		enqueuePos.store(0, std::memory_order_relaxed);
+		dequeuePos.store(0, std::memory_order_relaxed);
+	}
+
+	bool push (const T& value) {
+		Cell* cell;
+		size_t pos = enqueuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &cells[pos & mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+			if (diff == 0) {
+				if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if (diff < 0) {
+				return false; // Full.
+			} else {
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->value = value;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop (T& value) {
+		Cell* cell;
+		size_t pos = dequeuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			cell = &cells[pos & mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			ptrdiff_t diff = (ptrdiff_t)sequence - (ptrdiff_t)(pos + 1);
+			if (diff == 0) {
+				if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if (diff < 0) {
+				return false; // Empty.
+			} else {
+				pos = dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		value = cell->value;
+		cell->sequence.store(pos + mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t capacity () const { return mask + 1; }
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	ofxSpineQueue(const ofxSpineQueue&);
+	ofxSpineQueue& operator= (const ofxSpineQueue&);
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+	// Padding keeps producers and consumers off each other's cache line without over-aligning the owner.
+	char pad0[64];
+	std::atomic<size_t> enqueuePos;
+	char pad1[64];
+	std::atomic<size_t> dequeuePos;
+};
@@ -0,0 +1,137 @@
+#include "ofxSpineStats.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+ofxSpineStats::ofxSpineStats() {
+	reset();
+}
+
+void ofxSpineStats::reset () {
+	drawCalls = 0;
+	textureBinds = 0;
+	blendSwitches = 0;
+	vertices = 0;
+	triangles = 0;
+	batchOverflows = 0;
+	applyTime = 0;
+	worldTransformTime = 0;
+	vertexTime = 0;
+	submitTime = 0;
+}
+
+ofxSpineStats& ofxSpineStats::operator+= (const ofxSpineStats& other) {
+	drawCalls += other.drawCalls;
+	textureBinds += other.textureBinds;
+	blendSwitches += other.blendSwitches;
+	vertices += other.vertices;
+	triangles += other.triangles;
+	batchOverflows += other.batchOverflows;
+	applyTime += other.applyTime;
+	worldTransformTime += other.worldTransformTime;
+	vertexTime += other.vertexTime;
+	submitTime += other.submitTime;
+	return *this;
+}
+
+string ofxSpineStats::csvHeader () {
+	return "drawCalls,textureBinds,blendSwitches,vertices,triangles,batchOverflows,applyTime,worldTransformTime,vertexTime,submitTime";
+}
+
+string ofxSpineStats::toCSV () const {
+	stringstream out;
+	out << drawCalls << ',' << textureBinds << ',' << blendSwitches << ',' << vertices << ',' << triangles << ',' << batchOverflows << ','
+		<< applyTime << ',' << worldTransformTime << ',' << vertexTime << ',' << submitTime;
+	return out.str();
+}
+
+string ofxSpineStats::toJSON () const {
+	stringstream out;
+	out << "{\"drawCalls\":" << drawCalls
+		<< ",\"textureBinds\":" << textureBinds
+		<< ",\"blendSwitches\":" << blendSwitches
+		<< ",\"vertices\":" << vertices
+		<< ",\"triangles\":" << triangles
+		<< ",\"batchOverflows\":" << batchOverflows
+		<< ",\"applyTime\":" << applyTime
+		<< ",\"worldTransformTime\":" << worldTransformTime
+		<< ",\"vertexTime\":" << vertexTime
+		<< ",\"submitTime\":" << submitTime << "}";
+	return out.str();
+}
+
+ofxSpineStats& ofxSpineStats::global () {
+	static ofxSpineStats stats;
+	return stats;
+}
+
+// --- Trace
+
+namespace {
+	struct TraceEvent {
+		const char* name;
+		uint64_t start;
+		uint64_t duration;
+		size_t threadId;
+	};
+
+	std::mutex traceMutex;
+	vector<TraceEvent> traceEvents;
+	std::atomic<bool> traceRecording(false);
+}
+
+void ofxSpineTrace::begin () {
+	std::lock_guard<std::mutex> lock(traceMutex);
+	traceEvents.clear();
+	traceRecording = true;
+}
+
+bool ofxSpineTrace::isRecording () {
+	return traceRecording;
+}
+
+void ofxSpineTrace::addEvent (const char* name, uint64_t startMicros, uint64_t durationMicros) {
+	std::lock_guard<std::mutex> lock(traceMutex);
+	if (!traceRecording) return;
+	TraceEvent event = { name, startMicros, durationMicros, std::hash<std::thread::id>()(std::this_thread::get_id()) };
+	traceEvents.push_back(event);
+}
+
+bool ofxSpineTrace::end (const string& path) {
+	std::lock_guard<std::mutex> lock(traceMutex);
+	traceRecording = false;
+
+	ofstream out(ofToDataPath(path).c_str());
+	if (!out) return false;
+	out << "{\"traceEvents\":[";
+	for (size_t i = 0; i < traceEvents.size(); ++i) {
+		const TraceEvent& event = traceEvents[i];
+		if (i) out << ",\n";
+		out << "{\"name\":\"" << event.name << "\",\"cat\":\"spine\",\"ph\":\"X\",\"pid\":0,\"tid\":" << (event.threadId & 0xffff)
+			<< ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+	}
+	out << "]}\n";
+	traceEvents.clear();
+	return true;
+}
+
+// --- Scoped timer
+
+ofxSpineScopedTimer::ofxSpineScopedTimer(const char* name, ofxSpineCounter<double>* local, ofxSpineCounter<double>* global,
+	const ofxSpineCounter<double>* excluded)
+	: name(name), local(local), global(global), excluded(excluded), excludedStart(excluded ? (double)*excluded : 0),
+	start(ofGetElapsedTimeMicros()) {
+}
+
+ofxSpineScopedTimer::~ofxSpineScopedTimer() {
+	uint64_t duration = ofGetElapsedTimeMicros() - start;
+	if (excluded) {
+		double nested = (*excluded - excludedStart) * 1000;
+		duration = nested > 0 ? (nested < duration ? duration - (uint64_t)nested : 0) : duration;
+	}
+	double millis = duration / 1000.0;
+	if (local) *local += millis;
+	if (global) *global += millis;
+	if (ofxSpineTrace::isRecording()) ofxSpineTrace::addEvent(name, start, duration);
+}
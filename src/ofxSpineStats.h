@@ -0,0 +1,112 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+
+/* Set to 0 to compile out all counters and scoped timers. */
+#ifndef OFX_SPINE_STATS
+#define OFX_SPINE_STATS 1
+#endif
+
+/** A counter that may be added to from several threads at once, eg. update() on one and draw() on another. Reads and copies
+  * take a snapshot. */
+template<class T>
+class ofxSpineCounter
+{
+public:
+	ofxSpineCounter(T value = 0) : value(value) {}
+	ofxSpineCounter(const ofxSpineCounter& other) : value(other) {}
+
+	ofxSpineCounter& operator= (const ofxSpineCounter& other) {
+		value.store(other, std::memory_order_relaxed);
+		return *this;
+	}
+	ofxSpineCounter& operator= (T other) {
+		value.store(other, std::memory_order_relaxed);
+		return *this;
+	}
+	ofxSpineCounter& operator+= (T amount) {
+		T old = value.load(std::memory_order_relaxed);
+		while (!value.compare_exchange_weak(old, old + amount, std::memory_order_relaxed)) {}
+		return *this;
+	}
+	operator T () const { return value.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<T> value;
+};
+
+/** Per-frame renderer counters and timings. Every renderer keeps its own copy (reset at the start of update()) and adds each
+  * sample to global() as well. Call ofxSpineStats::global().reset() once per frame to get per-frame totals. The counters are
+  * atomic, so update() and draw() may run on different threads. */
+struct ofxSpineStats
+{
+	ofxSpineCounter<int> drawCalls;
+	ofxSpineCounter<int> textureBinds; // Draws with another texture than the draw before.
+	ofxSpineCounter<int> blendSwitches;
+	ofxSpineCounter<int> vertices;
+	ofxSpineCounter<int> triangles;
+	ofxSpineCounter<int> batchOverflows;
+
+	// Milliseconds. vertexTime does not include the batches submitted while the vertices are written; they are in submitTime.
+	ofxSpineCounter<double> applyTime;
+	ofxSpineCounter<double> worldTransformTime;
+	ofxSpineCounter<double> vertexTime;
+	ofxSpineCounter<double> submitTime;
+
+	ofxSpineStats();
+
+	void reset ();
+	ofxSpineStats& operator+= (const ofxSpineStats& other);
+
+	static string csvHeader ();
+	string toCSV () const;
+	string toJSON () const;
+
+	static ofxSpineStats& global ();
+};
+
+/** Records the scoped timers as Chrome trace events (chrome://tracing, Perfetto). */
+class ofxSpineTrace
+{
+public:
+	static void begin ();
+	static bool isRecording ();
+	static void addEvent (const char* name, uint64_t startMicros, uint64_t durationMicros);
+	/* Stops recording and writes the events to path. Returns false if the file could not be written. */
+	static bool end (const string& path);
+};
+
+/** Adds the lifetime of the object in milliseconds to local (may be 0) and global. Time added to excluded (may be 0) during
+  * that lifetime, by a nested timer, is left out. */
+class ofxSpineScopedTimer
+{
+public:
+	ofxSpineScopedTimer(const char* name, ofxSpineCounter<double>* local, ofxSpineCounter<double>* global,
+		const ofxSpineCounter<double>* excluded = 0);
+	~ofxSpineScopedTimer();
+
+private:
+	const char* name;
+	ofxSpineCounter<double>* local;
+	ofxSpineCounter<double>* global;
+	const ofxSpineCounter<double>* excluded;
+	double excludedStart;
+	uint64_t start;
+};
+
+#if OFX_SPINE_STATS
+#define OFX_SPINE_CONCAT_(a, b) a##b
+#define OFX_SPINE_CONCAT(a, b) OFX_SPINE_CONCAT_(a, b)
+#define OFX_SPINE_TIMER(stats, field) \
+	ofxSpineScopedTimer OFX_SPINE_CONCAT(_spineTimer, __LINE__)(#field, (stats) ? &(stats)->field : 0, &ofxSpineStats::global().field)
+#define OFX_SPINE_TIMER_EXCLUDING(stats, field, excludedField) \
+	ofxSpineScopedTimer OFX_SPINE_CONCAT(_spineTimer, __LINE__)(#field, &(stats)->field, &ofxSpineStats::global().field, &(stats)->excludedField)
+#define OFX_SPINE_COUNT(stats, field, amount) \
+	do { ofxSpineStats* _spineStats = (stats); if (_spineStats) _spineStats->field += (amount); ofxSpineStats::global().field += (amount); } while (0)
+#else
+#define OFX_SPINE_TIMER(stats, field) ((void)0)
+#define OFX_SPINE_TIMER_EXCLUDING(stats, field, excludedField) ((void)0)
+#define OFX_SPINE_COUNT(stats, field, amount) ((void)0)
+#endif
@@ -0,0 +1,327 @@
+#include "ofxSpineTextureLoader.h"
+#include "ofxSpineFileSource.h"
+#include <atomic>
+#include <mutex>
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
+static std::atomic<bool> compressedEnabled(true);
+static ofxSpineTextureLoader::Stats stats[2];
+static std::mutex statsMutex; // load() runs on the residency worker too.
+
+void ofxSpineTextureLoader::setCompressedEnabled (bool enabled) {
+	compressedEnabled = enabled;
+}
+
+bool ofxSpineTextureLoader::getCompressedEnabled () {
+	return compressedEnabled;
+}
+
+ofxSpineTextureLoader::Image::Image()
+	: width(0), height(0), compressed(false), internalFormat(0) {
+}
+
+size_t ofxSpineTextureLoader::Image::getBytes () const {
+	if (!compressed) return (size_t)width * height * 4;
+	size_t bytes = 0;
+	for (size_t i = 0; i < levels.size(); ++i) bytes += levels[i].size;
+	return bytes;
+}
+
+void ofxSpineTextureLoader::Image::clear () {
+	pixels.clear();
+	vector<unsigned char>().swap(data);
+	levels.clear();
+}
+
+/* Bytes per 4x4 block. */
+static int blockBytes (GLenum format) {
+	switch (format) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGB8_ETC2:
+	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+		return 8;
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+	case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+bool ofxSpineTextureLoader::isCompressedFormat (GLenum format) {
+	return blockBytes(format) != 0;
+}
+
+enum
+{
+	FORMATS_S3TC = 1,
+	FORMATS_BPTC = 2,
+	FORMATS_ETC2 = 4
+};
+
+static std::atomic<int> supportedFormats(-1); // FORMATS_* bits, -1 until detectFormats().
+
+void ofxSpineTextureLoader::detectFormats () {
+	if (supportedFormats.load() >= 0) return;
+	int formats = 0;
+	if (ofGLCheckExtension("GL_EXT_texture_compression_s3tc")) formats |= FORMATS_S3TC;
+	if (ofGLCheckExtension("GL_ARB_texture_compression_bptc")) formats |= FORMATS_BPTC;
+#ifdef TARGET_OPENGLES
+	formats |= FORMATS_ETC2;
+#else
+	if (ofGLCheckExtension("GL_ARB_ES3_compatibility")) formats |= FORMATS_ETC2;
+#endif
+	supportedFormats.store(formats);
+}
+
+bool ofxSpineTextureLoader::isFormatSupported (GLenum format) {
+	int formats = supportedFormats.load();
+	if (formats < 0) return false;
+	switch (format) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		return (formats & FORMATS_S3TC) != 0;
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		return (formats & FORMATS_BPTC) != 0;
+	case GL_COMPRESSED_RGB8_ETC2:
+	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+	case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		return (formats & FORMATS_ETC2) != 0;
+	default:
+		return false;
+	}
+}
+
+static uint32_t readU32 (const unsigned char* p, bool swap = false) {
+	uint32_t value = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+	if (swap) value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+	return value;
+}
+
+/* Fills levels from a chain of tightly packed mipmaps starting at offset, in a container of size bytes. */
+static bool packedLevels (ofxSpineTextureLoader::Image& image, size_t size, size_t offset, int levels) {
+	int width = image.width, height = image.height, block = blockBytes(image.internalFormat);
+	for (int i = 0; i < max(levels, 1); ++i) {
+		ofxSpineTextureLoader::Level level;
+		level.offset = offset;
+		level.size = (size_t)((width + 3) / 4) * ((height + 3) / 4) * block;
+		level.width = width;
+		level.height = height;
+		if (offset + level.size > size) return i > 0;
+		image.levels.push_back(level);
+		offset += level.size;
+		width = max(1, width / 2);
+		height = max(1, height / 2);
+	}
+	return true;
+}
+
+/* The parsers fill in the size, format and levels of image; the data stays in the file. */
+static bool parseKTX (const unsigned char* data, size_t size, ofxSpineTextureLoader::Image& image) {
+	static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+	if (size < 64 || memcmp(&data[0], identifier, 12) != 0) return false;
+	bool swap = readU32(&data[12]) != 0x04030201;
+	uint32_t glType = readU32(&data[16], swap);
+	image.internalFormat = readU32(&data[28], swap);
+	image.width = readU32(&data[36], swap);
+	image.height = readU32(&data[40], swap);
+	uint32_t faces = readU32(&data[52], swap);
+	uint32_t levels = max(1u, readU32(&data[56], swap));
+	uint32_t keyValueBytes = readU32(&data[60], swap);
+	if (glType != 0 || faces != 1 || !ofxSpineTextureLoader::isCompressedFormat(image.internalFormat)) return false;
+
+	// Every level is prefixed with its size and padded to 4 bytes.
+	size_t offset = 64 + keyValueBytes;
+	int width = image.width, height = image.height;
+	for (uint32_t i = 0; i < levels && offset + 4 <= size; ++i) {
+		ofxSpineTextureLoader::Level level;
+		level.size = readU32(&data[offset], swap);
+		level.offset = offset + 4;
+		level.width = width;
+		level.height = height;
+		if (level.offset + level.size > size) break;
+		image.levels.push_back(level);
+		offset = level.offset + ((level.size + 3) & ~(size_t)3);
+		width = max(1, width / 2);
+		height = max(1, height / 2);
+	}
+	return !image.levels.empty();
+}
+
+static bool parseDDS (const unsigned char* data, size_t size, ofxSpineTextureLoader::Image& image) {
+	if (size < 128 || memcmp(&data[0], "DDS ", 4) != 0) return false;
+	image.height = readU32(&data[12]);
+	image.width = readU32(&data[16]);
+	int levels = readU32(&data[28]);
+	const unsigned char* fourCC = &data[84];
+	size_t offset = 128;
+	if (memcmp(fourCC, "DXT1", 4) == 0) image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	else if (memcmp(fourCC, "DXT3", 4) == 0) image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+	else if (memcmp(fourCC, "DXT5", 4) == 0) image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	else if (memcmp(fourCC, "DX10", 4) == 0 && size >= 148) {
+		switch (readU32(&data[128])) { // DXGI_FORMAT
+		case 71: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break; // BC1_UNORM
+		case 74: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break; // BC2_UNORM
+		case 77: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break; // BC3_UNORM
+		case 98: image.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; break; // BC7_UNORM
+		default: return false;
+		}
+		offset = 148;
+	} else {
+		return false;
+	}
+	return packedLevels(image, size, offset, levels);
+}
+
+static string replaceExt (const string& path, const string& ext) {
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot == string::npos || (slash != string::npos && dot < slash)) return path + ext;
+	return path.substr(0, dot) + ext;
+}
+
+/* Reads the size from the IHDR chunk of a PNG without decoding it. */
+static bool readPNGSize (const unsigned char* data, size_t size, int& width, int& height) {
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (size < 24 || memcmp(data, signature, 8) != 0 || memcmp(data + 12, "IHDR", 4) != 0) return false;
+	width = readU32(data + 16, true);
+	height = readU32(data + 20, true);
+	return width > 0 && height > 0;
+}
+
+bool ofxSpineTextureLoader::load (const string& path, Image& image, bool decode) {
+	uint64_t start = ofGetElapsedTimeMicros();
+	image.clear();
+	if (compressedEnabled) {
+		const char* extensions[2] = { ".ktx", ".dds" };
+		for (int i = 0; i < 2; ++i) {
+			string compressedPath = replaceExt(path, extensions[i]);
+			shared_ptr<ofxSpineFile> file = ofxSpineOpenFile(compressedPath);
+			if (!file) continue;
+			const unsigned char* data = (const unsigned char*)file->getData();
+			bool parsed = i == 0 ? parseKTX(data, file->getSize(), image) : parseDDS(data, file->getSize(), image);
+			// Format support is only asked when there will be an upload; headless loading just needs the size.
+			if (parsed && (!decode || isFormatSupported(image.internalFormat))) {
+				image.path = compressedPath;
+				image.compressed = true;
+				if (decode) image.data.assign(data, data + file->getSize());
+				std::lock_guard<std::mutex> lock(statsMutex);
+				Stats& s = stats[1];
+				s.pages++;
+				s.loadMillis += (ofGetElapsedTimeMicros() - start) / 1000.0;
+				return true;
+			}
+			if (!parsed) ofLogWarning("ofxSpineTextureLoader") << "Unsupported container, using " << path << " instead: " << compressedPath;
+			image.clear();
+		}
+	}
+
+	image.path = path;
+	image.compressed = false;
+	image.internalFormat = 0;
+	shared_ptr<ofxSpineFile> file = ofxSpineOpenFile(path);
+	if (!file) return false;
+	const unsigned char* data = (const unsigned char*)file->getData();
+	if (decode || !readPNGSize(data, file->getSize(), image.width, image.height)) {
+		if (!ofLoadImage(image.pixels, ofBuffer(file->getData(), file->getSize()))) return false;
+		if (image.pixels.getNumChannels() != 4) image.pixels.setImageType(OF_IMAGE_COLOR_ALPHA);
+		image.width = image.pixels.getWidth();
+		image.height = image.pixels.getHeight();
+		if (!decode) image.pixels.clear();
+	}
+	std::lock_guard<std::mutex> lock(statsMutex);
+	Stats& s = stats[0];
+	s.pages++;
+	s.loadMillis += (ofGetElapsedTimeMicros() - start) / 1000.0;
+	return true;
+}
+
+static void countUpload (const ofxSpineTextureLoader::Image& image, uint64_t start) {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	ofxSpineTextureLoader::Stats& s = stats[image.compressed ? 1 : 0];
+	s.uploadMillis += (ofGetElapsedTimeMicros() - start) / 1000.0;
+	s.bytes += image.getBytes();
+}
+
+void ofxSpineTextureLoader::upload (const Image& image, ofTexture& texture) {
+	detectFormats();
+	uint64_t start = ofGetElapsedTimeMicros();
+	if (!image.compressed) {
+		texture.allocate(image.width, image.height, GL_RGBA);
+		texture.loadData(image.pixels, image.width, image.height, GL_RGBA);
+		countUpload(image, start);
+		return;
+	}
+
+	clear(texture);
+	GLuint id;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	for (size_t i = 0; i < image.levels.size(); ++i) {
+		const Level& level = image.levels[i];
+		glCompressedTexImage2D(GL_TEXTURE_2D, i, image.internalFormat, level.width, level.height, 0, level.size,
+			&image.data[level.offset]);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels.size() - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, image.levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// ofTexture does not own external ids, clear() below deletes it.
+	texture.setUseExternalTextureID(id);
+	ofTextureData& texData = texture.texData;
+	texData.textureTarget = GL_TEXTURE_2D;
+	texData.glInternalFormat = image.internalFormat;
+	texData.width = texData.tex_w = image.width;
+	texData.height = texData.tex_h = image.height;
+	texData.tex_t = 1;
+	texData.tex_u = 1;
+	texData.bFlipTexture = false;
+	texData.bAllocated = true;
+	countUpload(image, start);
+}
+
+void ofxSpineTextureLoader::clear (ofTexture& texture) {
+	if (texture.isAllocated() && isCompressedFormat(texture.texData.glInternalFormat)) {
+		glDeleteTextures(1, &texture.texData.textureID);
+		texture.texData.textureID = 0;
+		texture.texData.glInternalFormat = 0;
+		texture.texData.bAllocated = false;
+		return;
+	}
+	texture.clear();
+}
+
+ofxSpineTextureLoader::Stats ofxSpineTextureLoader::getStats (bool compressed) {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats[compressed ? 1 : 0];
+}
+
+void ofxSpineTextureLoader::resetStats () {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	memset(stats, 0, sizeof(stats));
+}
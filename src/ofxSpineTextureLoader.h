@@ -0,0 +1,69 @@
+//- GeistYp
+#pragma once
+
+#include "ofMain.h"
+
+/** Loads atlas page images. A pre-compressed KTX (BC1-3, BC7, ETC2) or DDS (DXT1/3/5, BC7 through DX10) file next to the
+  * page image, with the same name, is preferred when the GL supports its format; it is uploaded as is with
+  * glCompressedTexImage2D, including its mipmaps. Anything else is decoded to RGBA8 like before. Files are read through the
+  * installed ofxSpineFileSource. */
+class ofxSpineTextureLoader
+{
+public:
+
+	struct Level
+	{
+		size_t offset; // Into data.
+		size_t size;
+		int width, height;
+	};
+
+	struct Image
+	{
+		string path; // The file actually read.
+		int width, height;
+		bool compressed;
+		ofPixels pixels; // Uncompressed only.
+		GLenum internalFormat; // Compressed only.
+		vector<unsigned char> data;
+		vector<Level> levels;
+
+		Image();
+		/* Video memory once uploaded. */
+		size_t getBytes () const;
+		void clear ();
+	};
+
+	/* Per path totals since the last reset. */
+	struct Stats
+	{
+		int pages;
+		double loadMillis; // Reading and decoding.
+		double uploadMillis;
+		size_t bytes; // Video memory of the pages uploaded.
+	};
+
+	/* Prefer compressed containers when present. Default true. */
+	static void setCompressedEnabled (bool enabled);
+	static bool getCompressedEnabled ();
+
+	/* @param path The page image named in the atlas. Returns false if no image could be read. With decode false (headless
+	 * loading) only the size and levels of a compressed container are read, and of a PNG only its header; other images are
+	 * decoded and their pixels dropped. May be called on any thread once detectFormats() was. */
+	static bool load (const string& path, Image& image, bool decode = true);
+	/* Must be called on the GL thread. */
+	static void upload (const Image& image, ofTexture& texture);
+	/* Frees the texture's video memory, compressed or not. */
+	static void clear (ofTexture& texture);
+
+	static Stats getStats (bool compressed);
+	static void resetStats ();
+
+	/* Asks the GL which compressed formats it supports. Must be called on the GL thread before loading pages for upload;
+	 * atlas page creation and upload() do. */
+	static void detectFormats ();
+
+	static bool isCompressedFormat (GLenum internalFormat);
+	/* From detectFormats(), false before it. */
+	static bool isFormatSupported (GLenum internalFormat);
+};
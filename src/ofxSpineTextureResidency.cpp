@@ -0,0 +1,185 @@
+#include "ofxSpineTextureResidency.h"
+
+static shared_ptr<ofxSpineTextureResidency> textureResidency;
+
+void ofxSpineSetTextureResidency (shared_ptr<ofxSpineTextureResidency> residency) {
+	std::atomic_store(&textureResidency, residency);
+}
+
+shared_ptr<ofxSpineTextureResidency> ofxSpineGetTextureResidency () {
+	return std::atomic_load(&textureResidency);
+}
+
+shared_ptr<ofxSpineTextureResidency> ofxSpineTextureResidency::create (size_t budgetBytes) {
+	return make_shared<ofxSpineTextureResidency>(budgetBytes);
+}
+
+ofxSpineTextureResidency::ofxSpineTextureResidency(size_t budgetBytes)
+	: drawPlaceholder(false), maxUploadsPerFrame(2), retryFrames(60), budget(budgetBytes), frame(0), lastPage(0), lastEntry(0), stopping(false) {
+	memset(&stats, 0, sizeof(stats));
+	worker = std::thread(&ofxSpineTextureResidency::work, this);
+}
+
+ofxSpineTextureResidency::~ofxSpineTextureResidency() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	worker.join();
+}
+
+void ofxSpineTextureResidency::add (spAtlasPage* page, const string& path, size_t bytes) {
+	auto entry = make_shared<Page>();
+	entry->page = page;
+	entry->texture = (ofTexture*)page->rendererObject;
+	entry->path = path;
+	entry->bytes = bytes;
+	entry->lastDrawn = frame;
+	entry->failures = 0;
+	entry->retryFrame = 0;
+	entry->state = RESIDENT;
+	pages[page] = entry;
+	stats.residentBytes += bytes;
+	stats.peakBytes = max(stats.peakBytes, stats.residentBytes);
+}
+
+void ofxSpineTextureResidency::remove (spAtlasPage* page) {
+	auto found = pages.find(page);
+	if (found == pages.end()) return;
+	if (found->second->state == RESIDENT) stats.residentBytes -= found->second->bytes;
+	// A worker still decoding it holds its own reference; the result is dropped.
+	found->second->texture = 0;
+	pages.erase(found);
+	lastPage = 0;
+	lastEntry = 0;
+}
+
+ofTexture* ofxSpineTextureResidency::touch (const spAtlasPage* page) {
+	Page* entry;
+	if (page == lastPage) {
+		entry = lastEntry;
+	} else {
+		auto found = pages.find(page);
+		if (found == pages.end()) return (ofTexture*)page->rendererObject;
+		entry = found->second.get();
+		lastPage = page;
+		lastEntry = entry;
+	}
+	entry->lastDrawn = frame;
+	int state = entry->state.load(std::memory_order_acquire);
+	if (state == RESIDENT) return entry->texture;
+	if (state == BACKOFF && frame < entry->retryFrame) return getMissing();
+
+	stats.misses++;
+	if (state == EVICTED || state == BACKOFF) {
+		entry->state = LOADING;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pending.push_back(pages[page]);
+		}
+		wake.notify_one();
+	}
+	return getMissing();
+}
+
+ofTexture* ofxSpineTextureResidency::getMissing () {
+	if (!drawPlaceholder) return 0;
+	if (!placeholder.isAllocated()) {
+		unsigned char white[4] = { 255, 255, 255, 255 };
+		placeholder.allocate(1, 1, GL_RGBA);
+		placeholder.loadData(white, 1, 1, GL_RGBA);
+	}
+	return &placeholder;
+}
+
+void ofxSpineTextureResidency::work () {
+	while (true) {
+		shared_ptr<Page> entry;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+			if (stopping) return;
+			entry = pending.front();
+			pending.pop_front();
+		}
+		bool loaded = ofxSpineTextureLoader::load(entry->path, entry->image);
+		if (!loaded) ofLogError("ofxSpineTextureResidency") << "Error reloading " << entry->path;
+		entry->state.store(loaded ? DECODED : FAILED, std::memory_order_release);
+	}
+}
+
+void ofxSpineTextureResidency::unload (Page& entry) {
+	ofxSpineTextureLoader::clear(*entry.texture);
+	entry.state = EVICTED;
+	stats.residentBytes -= entry.bytes;
+	stats.evictions++;
+}
+
+void ofxSpineTextureResidency::update () {
+	int uploads = 0;
+	for (auto& item : pages) {
+		Page& entry = *item.second;
+		int state = entry.state.load(std::memory_order_acquire);
+		if (state == FAILED) {
+			entry.failures++;
+			entry.retryFrame = frame + ((uint64_t)max(1, retryFrames) << min(entry.failures - 1, 6));
+			entry.state = BACKOFF;
+			stats.failures++;
+			continue;
+		}
+		if (state != DECODED || uploads >= maxUploadsPerFrame) continue;
+		uint64_t start = ofGetElapsedTimeMicros();
+		ofxSpineTextureLoader::upload(entry.image, *entry.texture);
+		entry.bytes = entry.image.getBytes();
+		entry.image.clear();
+		entry.failures = 0;
+		entry.state = RESIDENT;
+		stats.residentBytes += entry.bytes;
+		stats.peakBytes = max(stats.peakBytes, stats.residentBytes);
+		stats.reloads++;
+		stats.uploadMillis += (ofGetElapsedTimeMicros() - start) / 1000.0;
+		uploads++;
+	}
+
+	// Least recently drawn first, sparing the pages of the frame that was just drawn.
+	while (stats.residentBytes > budget) {
+		Page* oldest = 0;
+		for (auto& item : pages) {
+			Page& entry = *item.second;
+			if (entry.state != RESIDENT || entry.lastDrawn >= frame) continue;
+			if (!oldest || entry.lastDrawn < oldest->lastDrawn) oldest = &entry;
+		}
+		if (!oldest) break;
+		unload(*oldest);
+	}
+	frame++;
+}
+
+bool ofxSpineTextureResidency::evict (const spAtlasPage* page) {
+	auto found = pages.find(page);
+	if (found == pages.end() || found->second->state != RESIDENT) return false;
+	unload(*found->second);
+	return true;
+}
+
+bool ofxSpineTextureResidency::isResident (const spAtlasPage* page) const {
+	auto found = pages.find(page);
+	return found != pages.end() && found->second->state == RESIDENT;
+}
+
+ofxSpineTextureResidency::Stats ofxSpineTextureResidency::getStats () const {
+	Stats result = stats;
+	result.budgetBytes = budget;
+	result.pages = pages.size();
+	result.residentPages = 0;
+	result.loadingPages = 0;
+	result.failedPages = 0;
+	for (auto& item : pages) {
+		int state = item.second->state;
+		if (state == RESIDENT) result.residentPages++;
+		else if (state == LOADING || state == DECODED) result.loadingPages++;
+		else if (state == FAILED || state == BACKOFF) result.failedPages++;
+	}
+	return result;
+}
@@ -0,0 +1,135 @@
+//- GeistYp
+#pragma once
+
+#include <spine/spine.h>
+#include "ofMain.h"
+#include "ofxSpineTextureLoader.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/** Keeps the GL textures of atlas pages within a byte budget. Once installed with ofxSpineSetTextureResidency(), every atlas
+  * page created afterwards is registered; drawing a page marks it as used (ofxSkeletonRenderer::getTexture). update(), called
+  * once per frame on the GL thread, uploads pages decoded in the background and then frees the least recently drawn pages
+  * until the budget is met. Pages drawn during the last frame are never evicted.
+  *
+  * An evicted page keeps its ofTexture object (page->rendererObject stays valid) but the texture is cleared. Drawing it queues
+  * a reload on the worker thread; until it is uploaded its attachments are skipped, or drawn with a 1x1 white placeholder when
+  * drawPlaceholder is set. A page that fails to reload is tried again after retryFrames frames, twice as long after every
+  * further failure. */
+class ofxSpineTextureResidency
+{
+public:
+
+	struct Stats
+	{
+		size_t budgetBytes;
+		size_t residentBytes;
+		size_t peakBytes;
+		int pages;
+		int residentPages;
+		int loadingPages;
+		int failedPages; // Waiting to be tried again.
+		int evictions; // Totals since creation.
+		int reloads;
+		int failures; // Reloads that failed.
+		int misses; // Draws of a page that was not resident, not counting failed pages waiting to be tried again.
+		double uploadMillis;
+	};
+
+	/* Draw attachments of non-resident pages with a white placeholder instead of skipping them. Default false. */
+	bool drawPlaceholder;
+	/* Decoded pages uploaded per update(), to spread upload stalls over frames. Default 2. */
+	int maxUploadsPerFrame;
+	/* Frames before a page that failed to reload is tried again, doubled on every further failure up to 64 times.
+	 * Default 60. */
+	int retryFrames;
+
+	static shared_ptr<ofxSpineTextureResidency> create (size_t budgetBytes);
+
+	ofxSpineTextureResidency(size_t budgetBytes);
+	~ofxSpineTextureResidency();
+
+	void setBudget (size_t budgetBytes) { budget = budgetBytes; }
+	size_t getBudget () const { return budget; }
+
+	/* Uploads decoded pages, evicts over the budget and starts the next frame. */
+	void update ();
+
+	/* Returns the page's texture, or the placeholder or 0 if the page is not resident. Marks the page as used this frame. */
+	ofTexture* touch (const spAtlasPage* page);
+
+	/* Frees the page's texture now. Returns false if the page is not registered or not resident. */
+	bool evict (const spAtlasPage* page);
+	bool isResident (const spAtlasPage* page) const;
+
+	Stats getStats () const;
+
+	// --- Called from _spAtlasPage_createTexture / _spAtlasPage_disposeTexture.
+	/* Registers a page whose texture was just loaded. */
+	void add (spAtlasPage* page, const string& path, size_t bytes);
+	void remove (spAtlasPage* page);
+
+private:
+	enum State
+	{
+		RESIDENT,
+		EVICTED,
+		LOADING,
+		DECODED,
+		FAILED, // Set by the worker, turned into BACKOFF by update().
+		BACKOFF
+	};
+
+	struct Page
+	{
+		spAtlasPage* page;
+		ofTexture* texture;
+		string path;
+		size_t bytes;
+		uint64_t lastDrawn;
+		int failures; // In a row.
+		uint64_t retryFrame; // While BACKOFF.
+		std::atomic<int> state;
+		ofxSpineTextureLoader::Image image; // Written by the worker while LOADING.
+	};
+
+	void unload (Page& page);
+	ofTexture* getMissing ();
+	void work ();
+
+	size_t budget;
+	uint64_t frame;
+	unordered_map<const spAtlasPage*, shared_ptr<Page> > pages;
+	const spAtlasPage* lastPage; // touch() is usually called for the same page many times in a row.
+	Page* lastEntry;
+	ofTexture placeholder;
+
+	Stats stats;
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;
+	deque<shared_ptr<Page> > pending;
+	bool stopping;
+};
+
+/** Texture of an atlas page (page->rendererObject), with the residency manager the page was registered with. The page keeps
+  * its manager alive and stays with it when another one is installed, so it is always removed from and reloaded by the
+  * manager that evicted it. */
+class ofxSpinePageTexture : public ofTexture
+{
+public:
+	shared_ptr<ofxSpineTextureResidency> residency; // May be 0.
+
+	static ofxSpinePageTexture* get (const spAtlasPage* page) {
+		return static_cast<ofxSpinePageTexture*>((ofTexture*)page->rendererObject);
+	}
+};
+
+/* Installs the residency manager used for atlas pages created from now on. Pages created before keep the manager they were
+ * created with, or none. May be 0 (default). */
+void ofxSpineSetTextureResidency (shared_ptr<ofxSpineTextureResidency> residency);
+shared_ptr<ofxSpineTextureResidency> ofxSpineGetTextureResidency ();